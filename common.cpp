@@ -42,13 +42,33 @@
 
 #include "common.hpp"
 
+#include <algorithm>
+
+// Process that embeds the test through its library API is not exited.
+// Setting is kept per thread, so that calls of the library don't
+// change how a test object of the embedding program exits
+static thread_local bool exit_unwinds = false;
+
+void set_exit_unwinds(bool unwinds) { exit_unwinds = unwinds; }
+
+bool get_exit_unwinds() { return exit_unwinds; }
+
+void exit_test(int32_t exit_value) {
+    if (exit_unwinds) {
+        test_exit_t test_exit;
+        test_exit.value_ = exit_value;
+        throw test_exit;
+    }
+    exit(exit_value);
+}
+
 void error_check(hsa_status_t hsa_error_code, int line_num, const char* str) {
     if (hsa_error_code != HSA_STATUS_SUCCESS && hsa_error_code != HSA_STATUS_INFO_BREAK) {
         printf("HSA Error Found!  In file: %s;   At line: %d\n", str, line_num);
         const char* string = NULL;
         hsa_status_string(hsa_error_code, &string);
         printf("Error: %s\n", string);
-        exit(EXIT_FAILURE);
+        exit_test(EXIT_FAILURE);
     }
 }
 
@@ -119,7 +139,11 @@ hsa_status_t FindGlobalPool(hsa_amd_memory_pool_t region, void* data) {
 double CalcMedian(vector<double> scores) {
     double median;
     size_t size = scores.size();
+    if (size == 0) {
+        return 0;
+    }
 
+    std::sort(scores.begin(), scores.end());
     if (size % 2 == 0)
         median = (scores[size / 2 - 1] + scores[size / 2]) / 2;
     else
@@ -128,7 +152,7 @@ double CalcMedian(vector<double> scores) {
     return median;
 }
 
-double CalcMean(vector<double> scores) {
+double CalcMean(const vector<double>& scores) {
     double mean = 0;
     size_t size = scores.size();
 
@@ -137,13 +161,17 @@ double CalcMean(vector<double> scores) {
     return mean / size;
 }
 
-double CalcStdDeviation(vector<double> scores, int score_mean) {
+double CalcStdDeviation(const vector<double>& scores, double score_mean) {
     double ret = 0.0;
+    if (scores.size() < 2) {
+        return ret;
+    }
+
     for (size_t i = 0; i < scores.size(); ++i) {
         ret += (scores[i] - score_mean) * (scores[i] - score_mean);
     }
 
-    ret /= scores.size();
+    ret /= (scores.size() - 1);
 
     return sqrt(ret);
 }
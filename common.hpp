@@ -72,6 +72,33 @@ using namespace std;
 // @Brief: Check HSA API return value
 void error_check(hsa_status_t hsa_error_code, int line_num, const char* str);
 
+// @Brief: Value thrown in place of exiting process when the test
+// runs embedded in a process through its library API
+typedef struct test_exit {
+    int32_t value_;
+} test_exit_t;
+
+// @Brief: Exit process with exit value, or unwind to caller of
+// library API with it if exits of calling thread are set to unwind
+void exit_test(int32_t exit_value);
+
+// @Brief: Set and get if exits of calling thread unwind to caller
+void set_exit_unwinds(bool unwinds);
+bool get_exit_unwinds();
+
+// @Brief: Set if exits of calling thread unwind for the lifetime
+// of the object, restoring the previous setting when destroyed
+class ExitUnwindScope {
+    public:
+        explicit ExitUnwindScope(bool unwinds) : saved_(get_exit_unwinds()) {
+            set_exit_unwinds(unwinds);
+        }
+        ~ExitUnwindScope() { set_exit_unwinds(saved_); }
+
+    private:
+        bool saved_;
+};
+
 // @Brief: Find the first avaliable GPU device
 hsa_status_t FindGpuDevice(hsa_agent_t agent, void* data);
 
@@ -82,12 +109,12 @@ hsa_status_t FindCpuDevice(hsa_agent_t agent, void* data);
 hsa_status_t FindGlobalPool(hsa_amd_memory_pool_t region, void* data);
 
 // @Brief: Calculate the mean number of the vector
-double CalcMean(vector<double> scores);
+double CalcMean(const vector<double>& scores);
 
 // @Brief: Calculate the Median valud of the vector
 double CalcMedian(vector<double> scores);
 
-// @Brief: Calculate the standard deviation of the vector
-double CalcStdDeviation(vector<double> scores, int score_mean);
+// @Brief: Calculate the sample standard deviation of the vector
+double CalcStdDeviation(const vector<double>& scores, double score_mean);
 
 #endif    // ROC_BANDWIDTH_TEST_COMMON_HPP
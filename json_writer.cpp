@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "json_writer.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+JsonWriter::JsonWriter(std::ostream& out) : out_(out) { after_key_ = false; }
+
+void JsonWriter::Indent() {
+    out_ << '\n';
+    for (size_t idx = 0; idx < has_value_.size(); idx++) {
+        out_ << "  ";
+    }
+}
+
+void JsonWriter::BeginValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (has_value_.empty()) {
+        return;
+    }
+    if (has_value_.back()) {
+        out_ << ',';
+    }
+    has_value_.back() = true;
+    Indent();
+}
+
+void JsonWriter::Close(char bracket) {
+    bool has_value = has_value_.back();
+    has_value_.pop_back();
+    if (has_value) {
+        Indent();
+    }
+    out_ << bracket;
+    if (has_value_.empty()) {
+        out_ << '\n';
+    }
+}
+
+void JsonWriter::BeginObject() {
+    BeginValue();
+    out_ << '{';
+    has_value_.push_back(false);
+}
+
+void JsonWriter::EndObject() { Close('}'); }
+
+void JsonWriter::BeginArray() {
+    BeginValue();
+    out_ << '[';
+    has_value_.push_back(false);
+}
+
+void JsonWriter::EndArray() { Close(']'); }
+
+void JsonWriter::Key(const std::string& key) {
+    BeginValue();
+    WriteString(key);
+    out_ << ": ";
+    after_key_ = true;
+}
+
+void JsonWriter::Value(const std::string& value) {
+    BeginValue();
+    WriteString(value);
+}
+
+void JsonWriter::WriteString(const std::string& value) {
+    out_ << '"';
+    for (size_t idx = 0; idx < value.size(); idx++) {
+        char ch = value[idx];
+        switch (ch) {
+            case '"':
+                out_ << "\\\"";
+                break;
+            case '\\':
+                out_ << "\\\\";
+                break;
+            case '\n':
+                out_ << "\\n";
+                break;
+            case '\t':
+                out_ << "\\t";
+                break;
+            default:
+                if ((unsigned char)ch < 0x20) {
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x", (unsigned char)ch);
+                    out_ << code;
+                } else {
+                    out_ << ch;
+                }
+        }
+    }
+    out_ << '"';
+}
+
+void JsonWriter::Value(const char* value) { Value(std::string(value)); }
+
+void JsonWriter::Value(double value) {
+    if (std::isfinite(value) == false) {
+        Null();
+        return;
+    }
+    BeginValue();
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    out_ << text;
+}
+
+void JsonWriter::Value(uint32_t value) {
+    BeginValue();
+    out_ << value;
+}
+
+void JsonWriter::Value(uint64_t value) {
+    BeginValue();
+    out_ << value;
+}
+
+void JsonWriter::Value(bool value) {
+    BeginValue();
+    out_ << ((value) ? "true" : "false");
+}
+
+void JsonWriter::Null() {
+    BeginValue();
+    out_ << "null";
+}
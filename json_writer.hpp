@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_JSON_WRITER_HPP
+#define ROC_BANDWIDTH_TEST_JSON_WRITER_HPP
+
+#include <stdint.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// @brief: Writes a JSON document to a stream as its values are
+// emitted. Keeps track of nesting to place commas and indentation,
+// but does not validate that keys are used only within objects
+class JsonWriter {
+    public:
+        explicit JsonWriter(std::ostream& out);
+
+        void BeginObject();
+        void EndObject();
+        void BeginArray();
+        void EndArray();
+
+        // @brief: Emit key of the next member of an object
+        void Key(const std::string& key);
+
+        // @brief: Emit a value. Numbers that are not finite
+        // are emitted as null, which JSON has no other form for
+        void Value(const std::string& value);
+        void Value(const char* value);
+        void Value(double value);
+        void Value(uint32_t value);
+        void Value(uint64_t value);
+        void Value(bool value);
+        void Null();
+
+    private:
+        // @brief: Emit separator and indentation before a value
+        void BeginValue();
+        void Indent();
+        void WriteString(const std::string& value);
+        void Close(char bracket);
+
+        std::ostream& out_;
+
+        // One entry per open object or array, set
+        // once the first value in it is emitted
+        std::vector<bool> has_value_;
+
+        // Set when a key is waiting for its value
+        bool after_key_;
+};
+
+#endif  //  ROC_BANDWIDTH_TEST_JSON_WRITER_HPP
@@ -49,56 +49,25 @@
 using namespace std;
 
 int main(int argc, char** argv) {
-    // Default behavior is implemented as two runs
-    uint32_t arg_cnt = argc;
+    // Default behavior is implemented as two scenarios, copies among
+    // all devices in one and then the other direction, run by one
+    // session that initializes runtime and discovers topology once
     if (argc == 1) {
-        argc++;
-        argv[1] = (char*)"-a";
         setenv("ROCM_BW_DEFAULT_RUN", "true", true);
     }
 
     // Create the Bandwidth test object
-    RocmBandwidthTest bw_test1(argc, argv);
+    RocmBandwidthTest bw_test(argc, argv);
 
     // Initialize the Bandwidth test object
-    bw_test1.SetUp();
+    bw_test.SetUp();
 
     // Run the Bandwidth tests requested by user
-    bw_test1.Run();
-
-    // Return if user has not passed in any arguments
-    // Display the time taken by various tests
-    // Release the Bandwidth test object resources
-    if (arg_cnt != 1) {
-        bw_test1.Display();
-        bw_test1.Close();
-        return bw_test1.GetExitValue();
-    }
-
-    // Run the second iteration of copy requests
-    if (arg_cnt == 1) {
-        optind = 1;
-        argv[1] = (char*)"-A";
-    }
-
-    // Create the Bandwidth test object
-    RocmBandwidthTest bw_test2(argc, argv);
-
-    // Initialize the Bandwidth test object
-    bw_test2.SetUp();
-
-    // Run the Bandwidth tests requested by user
-    bw_test2.Run();
+    bw_test.Run();
 
     // Display the time taken by various tests
     // and then release associated resources
-    bw_test1.Display();
-    bw_test1.Close();
-
-    // Display the time taken by various tests
-    // and then release associated resources
-    bw_test2.Display();
-    bw_test2.Close();
-
-    return 0;
+    bw_test.Display();
+    bw_test.Close();
+    return bw_test.GetExitValue();
 }
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ROC_BANDWIDTH_H__
+#define __ROC_BANDWIDTH_H__
+
+// C API of library that embeds the bandwidth test in a process. A
+// session initializes its own reference of Roc runtime and discovers
+// topology once, and then builds and runs any number of requests.
+// Requests take the options of the command line, and errors are
+// returned as status instead of exiting process. Calls on a session
+// must not overlap, while separate sessions may be used by threads
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define RBT_API __attribute__((visibility("default")))
+#else
+#define RBT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum rbt_status {
+    // Call completed successfully
+    RBT_STATUS_SUCCESS = 0,
+
+    // Roc runtime failed, session should be destroyed
+    RBT_STATUS_ERROR = 1,
+
+    // Argument of call is NULL or out of range
+    RBT_STATUS_INVALID_ARGUMENT = 2,
+
+    // Options of request are illegal or can't be combined
+    RBT_STATUS_INVALID_REQUEST = 3,
+
+    // Request ran but one or more of its copies failed validation
+    RBT_STATUS_VALIDATION_FAILED = 4,
+
+    // Request ran and its copies regressed against baseline of -C
+    RBT_STATUS_REGRESSION = 5,
+
+    // Request ran and health check of -H graded a link degraded
+    RBT_STATUS_LINK_DEGRADED = 6,
+
+    // Request ran and health check of -H graded a link failed
+    RBT_STATUS_LINK_FAILED = 7,
+
+    // Dry run of -n found a pool that can't hold buffers of copies
+    RBT_STATUS_POOL_TOO_SMALL = 8
+} rbt_status_t;
+
+typedef enum rbt_device_type {
+    RBT_DEVICE_TYPE_CPU = 0,
+    RBT_DEVICE_TYPE_GPU = 1
+} rbt_device_type_t;
+
+typedef enum rbt_link_type {
+    RBT_LINK_TYPE_SELF = 0,
+    RBT_LINK_TYPE_PCIE = 1,
+    RBT_LINK_TYPE_XGMI = 2,
+    RBT_LINK_TYPE_OTHER = 3,
+    RBT_LINK_TYPE_NO_PATH = 4
+} rbt_link_type_t;
+
+typedef struct rbt_session_s* rbt_session_t;
+
+// Device as used by requests, which is a memory pool of an agent
+typedef struct rbt_device_info {
+    uint32_t device_id;
+    uint32_t agent_index;
+    rbt_device_type_t type;
+    char name[64];
+    char bdf_id[16];
+    uint64_t allocable_size;
+    int32_t fine_grained;
+} rbt_device_info_t;
+
+// Link from agent of a device to agent of another one
+typedef struct rbt_link_info {
+    int32_t path_exists;
+    uint32_t hops;
+    rbt_link_type_t type;
+    uint32_t weight;
+} rbt_link_info_t;
+
+// Copy built for a request, whose results are one per size
+typedef struct rbt_transaction_info {
+    uint32_t src_device_id;
+    uint32_t dst_device_id;
+    int32_t bidir;
+    uint32_t result_count;
+} rbt_transaction_info_t;
+
+// Times are in seconds and bandwidths in GB/s. A size that failed
+// validation has valid set to zero and its other values unset
+typedef struct rbt_result {
+    uint64_t size;
+    int32_t valid;
+    double avg_time;
+    double min_time;
+    double avg_bandwidth;
+    double peak_bandwidth;
+} rbt_result_t;
+
+// @brief: Create a session, initializing runtime and discovering topology
+RBT_API rbt_status_t rbt_session_create(rbt_session_t* session);
+
+// @brief: Release resources of session and its reference of runtime
+RBT_API rbt_status_t rbt_session_destroy(rbt_session_t session);
+
+// @brief: Query devices of session and links between them
+RBT_API rbt_status_t rbt_get_device_count(rbt_session_t session, uint32_t* count);
+RBT_API rbt_status_t rbt_get_device_info(rbt_session_t session, uint32_t device_id,
+                                         rbt_device_info_t* info);
+RBT_API rbt_status_t rbt_get_link_info(rbt_session_t session, uint32_t src_device_id,
+                                       uint32_t dst_device_id, rbt_link_info_t* info);
+
+// @brief: Build copies of a request from options of the command line,
+// for example {"-s", "0", "-d", "1", "-m", "64"}. Options -f and -D
+// and exporter mode are not supported
+RBT_API rbt_status_t rbt_build_request(rbt_session_t session, int argc, const char* const* argv);
+
+// @brief: Query copies built for request
+RBT_API rbt_status_t rbt_get_transaction_count(rbt_session_t session, uint32_t* count);
+RBT_API rbt_status_t rbt_get_transaction_info(rbt_session_t session, uint32_t trans_idx,
+                                              rbt_transaction_info_t* info);
+
+// @brief: Run copies of request. If checks of more than one kind fail,
+// status is of the most severe of them, as exit value of test is
+RBT_API rbt_status_t rbt_run(rbt_session_t session);
+
+// @brief: Retrieve result of a copy for one of its sizes
+RBT_API rbt_status_t rbt_get_result(rbt_session_t session, uint32_t trans_idx,
+                                    uint32_t result_idx, rbt_result_t* result);
+
+// @brief: Return string that describes a status
+RBT_API const char* rbt_status_string(rbt_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    //  __ROC_BANDWIDTH_H__
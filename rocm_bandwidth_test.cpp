@@ -54,6 +54,7 @@
 #include <cmath>
 #include <cstring>
 #include <limits>
+#include <map>
 #include <sstream>
 #include <thread>
 
@@ -72,10 +73,13 @@ const size_t RocmBandwidthTest::LATENCY_SIZE_LIST[] = {
     128,       256,       512,       1 * 1024,   2 * 1024,   4 * 1024,  8 * 1024,
     16 * 1024, 32 * 1024, 64 * 1024, 128 * 1024, 256 * 1024, 512 * 1024};
 
+// Chunk size is bound to a reference by std::min
+const size_t RocmBandwidthTest::INIT_CHUNK_SIZE;
+
 uint32_t RocmBandwidthTest::GetIterationNum() { return (validate_) ? 1 : (num_iteration_ + 1); }
 
 void RocmBandwidthTest::AcquireAccess(hsa_agent_t agent, void* ptr) {
-    err_ = hsa_amd_agents_allow_access(1, &agent, NULL, ptr);
+    err_ = transport_->AllowAccess(agent, ptr);
     ErrorCheck(err_);
 }
 
@@ -95,65 +99,130 @@ void RocmBandwidthTest::AcquirePoolAcceses(uint32_t src_dev_idx, hsa_agent_t src
     return;
 }
 
-void RocmBandwidthTest::InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t cpy_dev_idx,
-                                            hsa_agent_t cpy_agent) {
-    // Allocate host buffers and setup accessibility for copy operation
-    if (init_src_ == NULL) {
-        err_ = hsa_amd_memory_pool_allocate(sys_pool_, size, 0, (void**)&init_src_);
+int32_t RocmBandwidthTest::GetStagingAgent(uint32_t dev_idx) const {
+    // Pick Cpu agent with a system pool that is nearest to device
+    int32_t cpu_dev_idx = -1;
+    uint32_t cpu_weight = 0;
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        if (staging_list_[idx].valid_ == false) {
+            continue;
+        }
+        uint32_t weight = (idx == dev_idx) ? 0 : GetLinkProp(LINK_PROP_WEIGHT, idx, dev_idx);
+        if ((cpu_dev_idx == -1) || (weight < cpu_weight)) {
+            cpu_dev_idx = idx;
+            cpu_weight = weight;
+        }
+    }
+    return cpu_dev_idx;
+}
+
+staging_buf_t& RocmBandwidthTest::GetStagingBuf(size_t size, uint32_t dev_idx) {
+    int32_t cpu_dev_idx = GetStagingAgent(dev_idx);
+    if (cpu_dev_idx == -1) {
+        std::cout << "No system memory pool found to stage buffers" << std::endl;
+        exit_test(1);
+    }
+
+    // Allocate host buffers on first use and fill initialization buffer
+    staging_buf_t& staging = staging_list_[cpu_dev_idx];
+    if (staging.init_src_ == NULL) {
+        err_ = transport_->Allocate(staging.pool_, size, (void**)&staging.init_src_);
         ErrorCheck(err_);
-        long double* src_buf = (long double*)init_src_;
-        uint32_t count = (size / sizeof(long double));
-        for (uint32_t idx = 0; idx < count; idx++) {
+        // Pattern is computed for the first chunk and replicated over
+        // the rest, so buffers of many gigabytes initialize quickly
+        long double* src_buf = (long double*)staging.init_src_;
+        size_t chunk = std::min(size, INIT_CHUNK_SIZE);
+        size_t count = (chunk / sizeof(long double));
+        for (size_t idx = 0; idx < count; idx++) {
             src_buf[idx] = (init_) ? init_val_ : sin(idx);
         }
-        err_ = hsa_signal_create(0, 0, NULL, &init_signal_);
+        char* chunk_buf = (char*)staging.init_src_;
+        for (size_t offset = chunk; offset < size; offset += chunk) {
+            std::memcpy(chunk_buf + offset, chunk_buf, std::min(chunk, (size - offset)));
+        }
+    }
+    if ((validate_) && (staging.validate_dst_ == NULL)) {
+        err_ = transport_->Allocate(staging.pool_, size, (void**)&staging.validate_dst_);
         ErrorCheck(err_);
     }
+    if (init_signal_.handle == 0) {
+        err_ = transport_->CreateSignal(0, &init_signal_);
+        ErrorCheck(err_);
+    }
+    return staging;
+}
+
+void RocmBandwidthTest::InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t cpy_dev_idx,
+                                            hsa_agent_t cpy_agent) {
+    // Allocate host buffers on socket of copying device
+    staging_buf_t& staging = GetStagingBuf(size, cpy_dev_idx);
 
     // If copying agent is a CPU, use memcpy to initialize copy buffer
     hsa_device_type_t cpy_dev_type = agent_list_[cpy_dev_idx].device_type_;
     if (cpy_dev_type == HSA_DEVICE_TYPE_CPU) {
-        std::memcpy(buf_cpy, init_src_, size);
+        std::memcpy(buf_cpy, staging.init_src_, size);
         return;
     }
 
     // Copying device is a Gpu, setup buffer access
     // before copying initialization buffer
-    AcquireAccess(cpy_agent, init_src_);
-    hsa_signal_store_relaxed(init_signal_, 1);
-    copy_buffer(buf_cpy, cpy_agent, init_src_, cpu_agent_, size, init_signal_);
+    AcquireAccess(cpy_agent, staging.init_src_);
+    transport_->StoreSignal(init_signal_, 1);
+    copy_buffer(buf_cpy, cpy_agent, staging.init_src_, staging.agent_, size, init_signal_);
     return;
 }
 
 bool RocmBandwidthTest::ValidateDstBuffer(size_t max_size, size_t curr_size, void* buf_cpy,
                                           uint32_t cpy_dev_idx, hsa_agent_t cpy_agent) {
-    // Allocate host buffers and setup accessibility for copy operation
-    if (validate_dst_ == NULL) {
-        err_ = hsa_amd_memory_pool_allocate(sys_pool_, max_size, 0, (void**)&validate_dst_);
-        ErrorCheck(err_);
-    }
+    // Allocate host buffers on socket of copying device
+    staging_buf_t& staging = GetStagingBuf(max_size, cpy_dev_idx);
+    void* validate_dst = staging.validate_dst_;
 
     // If Copy device is a Gpu setup buffer access
-    std::memset(validate_dst_, ~(0x23), curr_size);
+    std::memset(validate_dst, ~(0x23), curr_size);
     hsa_device_type_t cpy_dev_type = agent_list_[cpy_dev_idx].device_type_;
     if (cpy_dev_type == HSA_DEVICE_TYPE_GPU) {
-        AcquireAccess(cpy_agent, validate_dst_);
-        hsa_signal_store_relaxed(init_signal_, 1);
-        copy_buffer(validate_dst_, cpu_agent_, buf_cpy, cpy_agent, curr_size, init_signal_);
+        AcquireAccess(cpy_agent, validate_dst);
+        transport_->StoreSignal(init_signal_, 1);
+        copy_buffer(validate_dst, staging.agent_, buf_cpy, cpy_agent, curr_size, init_signal_);
     } else {
         // Copying device is a CPU, copy dst buffer
         // into validation buffer
-        std::memcpy(validate_dst_, buf_cpy, curr_size);
+        std::memcpy(validate_dst, buf_cpy, curr_size);
     }
 
     // Compare initialization buffer with validation buffer
-    err_ = (hsa_status_t)std::memcmp(init_src_, validate_dst_, curr_size);
+    err_ = (hsa_status_t)std::memcmp(staging.init_src_, validate_dst, curr_size);
     if (err_ != HSA_STATUS_SUCCESS) {
-        exit_value_ = err_;
+        RaiseExitValue(err_);
     }
     return (err_ == HSA_STATUS_SUCCESS);
 }
 
+uint32_t RocmBandwidthTest::GetExitRank(int32_t value) const {
+    // Any value other than those of checks is of failed validation
+    switch (value) {
+        case 0:
+            return 0;
+        case DRY_RUN_EXIT_VALUE:
+            return 1;
+        case REGRESSION_EXIT_VALUE:
+            return 2;
+        case HEALTH_DEGRADED_EXIT_VALUE:
+            return 3;
+        case HEALTH_FAIL_EXIT_VALUE:
+            return 4;
+        default:
+            return 5;
+    }
+}
+
+void RocmBandwidthTest::RaiseExitValue(int32_t value) {
+    if (GetExitRank(value) > GetExitRank(exit_value_)) {
+        exit_value_ = value;
+    }
+}
+
 void RocmBandwidthTest::AllocateConcurrentCopyResources(
     bool bidir, vector<async_trans_t>& trans_list, vector<void*>& buf_list,
     vector<hsa_agent_t>& dev_list, vector<uint32_t>& dev_idx_list, vector<hsa_signal_t>& sig_list,
@@ -163,6 +232,9 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
     uint32_t trans_cnt = trans_list.size();
     size_t max_size = size_list_.back();
 
+    // Source buffer of each pool if copies share them
+    vector<void*> shared_src(pool_list_.size(), (void*)NULL);
+
     // Common variables used in different loops
     void* buf_src;
     void* buf_dst;
@@ -189,10 +261,17 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
         dst_dev_idx = pool_list_[dst_idx].agent_index_;
 
         // Allocate buffers and signal for forward copy operation
-        AllocateCopyBuffers(max_size, buf_src, src_pool, buf_dst, dst_pool);
+        bool init_src = true;
+        if ((share_src_bufs_) && (shared_src[src_idx] != NULL)) {
+            buf_src = shared_src[src_idx];
+            buf_dst = AcquireBuffer(dst_pool, max_size);
+            init_src = false;
+        } else {
+            AllocateCopyBuffers(max_size, buf_src, src_pool, buf_dst, dst_pool);
+            shared_src[src_idx] = buf_src;
+        }
 
-        err_ = hsa_signal_create(1, 0, NULL, &signal);
-        ErrorCheck(err_);
+        signal = AcquireSignal();
 
         // Acquire access to destination buffers
         AcquirePoolAcceses(src_dev_idx, src_dev, buf_src, dst_dev_idx, dst_dev, buf_dst);
@@ -206,14 +285,23 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
         dev_idx_list.push_back(dst_dev_idx);
 
         // Initialize source buffers with data that could be verified
-        InitializeSrcBuffer(max_size, buf_src, src_dev_idx, src_dev);
+        if (init_src) {
+            InitializeSrcBuffer(max_size, buf_src, src_dev_idx, src_dev);
+        }
 
         // For bidirectional copies allocate buffers
         // and signal for reverse direction as well
         if (bidir) {
-            AllocateCopyBuffers(max_size, buf_src, dst_pool, buf_dst, src_pool);
-            err_ = hsa_signal_create(1, 0, NULL, &signal);
-            ErrorCheck(err_);
+            init_src = true;
+            if ((share_src_bufs_) && (shared_src[dst_idx] != NULL)) {
+                buf_src = shared_src[dst_idx];
+                buf_dst = AcquireBuffer(src_pool, max_size);
+                init_src = false;
+            } else {
+                AllocateCopyBuffers(max_size, buf_src, dst_pool, buf_dst, src_pool);
+                shared_src[dst_idx] = buf_src;
+            }
+            signal = AcquireSignal();
 
             // Acquire access to destination buffers
             AcquirePoolAcceses(dst_dev_idx, dst_dev, buf_src, src_dev_idx, src_dev, buf_dst);
@@ -227,49 +315,129 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
             dev_idx_list.push_back(src_dev_idx);
 
             // Initialize source buffers with data that could be verified
-            InitializeSrcBuffer(max_size, buf_src, dst_dev_idx, dst_dev);
+            if (init_src) {
+                InitializeSrcBuffer(max_size, buf_src, dst_dev_idx, dst_dev);
+            }
         }
     }
 }
 
 void RocmBandwidthTest::AllocateCopyBuffers(size_t size, void*& src, hsa_amd_memory_pool_t src_pool,
                                             void*& dst, hsa_amd_memory_pool_t dst_pool) {
-    // Allocate buffers in src and dst pools for forward copy
-    err_ = hsa_amd_memory_pool_allocate(src_pool, size, 0, &src);
-    ErrorCheck(err_);
-    err_ = hsa_amd_memory_pool_allocate(dst_pool, size, 0, &dst);
+    // Acquire buffers in src and dst pools for forward copy
+    src = AcquireBuffer(src_pool, size);
+    dst = AcquireBuffer(dst_pool, size);
+}
+
+void* RocmBandwidthTest::AcquireBuffer(hsa_amd_memory_pool_t pool, size_t size) {
+    // Reuse the smallest idle buffer of pool that is large enough
+    int32_t found = -1;
+    uint32_t count = buf_cache_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        const cached_buf_t& cached = buf_cache_[idx];
+        if ((cached.busy_) || (cached.pool_.handle != pool.handle) || (cached.size_ < size)) {
+            continue;
+        }
+        if ((found == -1) || (cached.size_ < buf_cache_[found].size_)) {
+            found = idx;
+        }
+    }
+    if (found != -1) {
+        buf_cache_[found].busy_ = true;
+        return buf_cache_[found].buf_;
+    }
+
+    // Idle buffers of pool that are too small are freed before
+    // allocating a larger one, so pool is not held twice over
+    for (uint32_t idx = count; idx > 0; idx--) {
+        cached_buf_t& cached = buf_cache_[idx - 1];
+        if ((cached.busy_ == false) && (cached.pool_.handle == pool.handle)) {
+            err_ = transport_->Free(cached.buf_);
+            ErrorCheck(err_);
+            buf_cache_.erase(buf_cache_.begin() + (idx - 1));
+        }
+    }
+
+    cached_buf_t cached;
+    err_ = transport_->Allocate(pool, size, &cached.buf_);
     ErrorCheck(err_);
+    cached.pool_ = pool;
+    cached.size_ = size;
+    cached.busy_ = true;
+    buf_cache_.push_back(cached);
+    return cached.buf_;
+}
+
+hsa_signal_t RocmBandwidthTest::AcquireSignal() {
+    hsa_signal_t signal;
+    if (signal_cache_.empty()) {
+        err_ = transport_->CreateSignal(1, &signal);
+        ErrorCheck(err_);
+        return signal;
+    }
+
+    // Signals are returned as if they were just created
+    signal = signal_cache_.back();
+    signal_cache_.pop_back();
+    transport_->StoreSignal(signal, 1);
+    return signal;
 }
 
 void RocmBandwidthTest::ReleaseBuffers(std::vector<void*>& buffer_list) {
+    uint32_t count = buf_cache_.size();
     for (uint32_t idx = 0; idx < buffer_list.size(); idx++) {
-        void* buffer = buffer_list[idx];
-        err_ = hsa_amd_memory_pool_free(buffer);
-        ErrorCheck(err_);
+        for (uint32_t jdx = 0; jdx < count; jdx++) {
+            if (buf_cache_[jdx].buf_ == buffer_list[idx]) {
+                buf_cache_[jdx].busy_ = false;
+                break;
+            }
+        }
     }
 }
 
 void RocmBandwidthTest::ReleaseSignals(std::vector<hsa_signal_t>& signal_list) {
     for (uint32_t idx = 0; idx < signal_list.size(); idx++) {
-        hsa_signal_t signal = signal_list[idx];
-        err_ = hsa_signal_destroy(signal);
+        signal_cache_.push_back(signal_list[idx]);
+    }
+}
+
+void RocmBandwidthTest::FreeSessionResources() {
+    uint32_t count = buf_cache_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        err_ = transport_->Free(buf_cache_[idx].buf_);
         ErrorCheck(err_);
     }
+    buf_cache_.clear();
+
+    count = signal_cache_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        err_ = transport_->DestroySignal(signal_cache_[idx]);
+        ErrorCheck(err_);
+    }
+    signal_cache_.clear();
 }
 
 double RocmBandwidthTest::GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd,
-                                         hsa_signal_t signal_rev) {
+                                         hsa_signal_t signal_rev, sample_record_t* record) {
     // Obtain time taken for forward copy
     hsa_amd_profiling_async_copy_time_t async_time_fwd = {0};
-    err_ = hsa_amd_profiling_get_async_copy_time(signal_fwd, &async_time_fwd);
+    err_ = transport_->GetCopyTime(signal_fwd, &async_time_fwd);
     ErrorCheck(err_);
+    if (record != NULL) {
+        record->gpu_start_fwd_ = async_time_fwd.start;
+        record->gpu_end_fwd_ = async_time_fwd.end;
+    }
     if (bidir == false) {
         return (async_time_fwd.end - async_time_fwd.start);
     }
 
     hsa_amd_profiling_async_copy_time_t async_time_rev = {0};
-    err_ = hsa_amd_profiling_get_async_copy_time(signal_rev, &async_time_rev);
+    err_ = transport_->GetCopyTime(signal_rev, &async_time_rev);
     ErrorCheck(err_);
+    if (record != NULL) {
+        record->gpu_start_rev_ = async_time_rev.start;
+        record->gpu_end_rev_ = async_time_rev.end;
+    }
 
     // Compute time taken to copy
     double start = min(async_time_fwd.start, async_time_rev.start);
@@ -290,6 +458,29 @@ double RocmBandwidthTest::GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd,
     return copy_time;
 }
 
+void RocmBandwidthTest::SetSampleEndpoints(const async_trans_t& trans,
+                                           sample_record_t& record) const {
+    record.trans_id_ = trans.trans_id_;
+    record.src_pool_idx_ = trans.copy.src_idx_;
+    record.dst_pool_idx_ = trans.copy.dst_idx_;
+    record.src_dev_idx_ = pool_list_[trans.copy.src_idx_].agent_index_;
+    record.dst_dev_idx_ = pool_list_[trans.copy.dst_idx_].agent_index_;
+}
+
+void RocmBandwidthTest::WriteSample(sample_record_t& record) {
+    if (sample_writer_.Write(record) == false) {
+        std::cout << "Failed to write sample file: " << sample_file_path_ << std::endl;
+        exit_test(1);
+    }
+}
+
+void RocmBandwidthTest::CloseSampleFile() {
+    if (sample_writer_.Close() == false) {
+        std::cout << "Failed to write sample file: " << sample_file_path_ << std::endl;
+        exit_test(1);
+    }
+}
+
 void RocmBandwidthTest::WaitForCopyCompletion(vector<hsa_signal_t>& signal_list) {
     hsa_wait_state_t policy =
         (bw_blocking_run_ == NULL) ? HSA_WAIT_STATE_ACTIVE : HSA_WAIT_STATE_BLOCKED;
@@ -297,7 +488,7 @@ void RocmBandwidthTest::WaitForCopyCompletion(vector<hsa_signal_t>& signal_list)
     uint32_t size = signal_list.size();
     for (uint32_t idx = 0; idx < size; idx++) {
         hsa_signal_t signal = signal_list[idx];
-        while (hsa_signal_wait_acquire(signal, HSA_SIGNAL_CONDITION_LT, 1, uint64_t(-1), policy))
+        while (transport_->WaitSignal(signal, HSA_SIGNAL_CONDITION_LT, 1, policy))
             ;
     }
 }
@@ -305,12 +496,11 @@ void RocmBandwidthTest::WaitForCopyCompletion(vector<hsa_signal_t>& signal_list)
 void RocmBandwidthTest::copy_buffer(void* dst, hsa_agent_t dst_agent, void* src,
                                     hsa_agent_t src_agent, size_t size, hsa_signal_t signal) {
     // Copy from src into dst buffer
-    err_ = hsa_amd_memory_async_copy(dst, dst_agent, src, src_agent, size, 0, NULL, signal);
+    err_ = transport_->CopyAsync(dst, dst_agent, src, src_agent, size, 0, NULL, signal);
     ErrorCheck(err_);
 
     // Wait for the forward copy operation to complete
-    while (hsa_signal_wait_acquire(signal, HSA_SIGNAL_CONDITION_LT, 1, uint64_t(-1),
-                                   HSA_WAIT_STATE_ACTIVE))
+    while (transport_->WaitSignal(signal, HSA_SIGNAL_CONDITION_LT, 1, HSA_WAIT_STATE_ACTIVE))
         ;
 }
 
@@ -329,6 +519,10 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
     vector<hsa_signal_t> sig_list;
     vector<hsa_amd_memory_pool_t> pool_list;
 
+    // Run on NUMA nodes of host buffers, as serial copies do
+    cpu_set_t saved_cpus;
+    AffinityScope affinity(BindCopyThread(trans_list, &saved_cpus), saved_cpus);
+
     // Allocate resources for the various transactions
     AllocateConcurrentCopyResources(bidir, trans_list, buf_list, dev_list, dev_idx_list, sig_list,
                                     pool_list);
@@ -342,13 +536,28 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
 
     // Signa to trigger all copy requests to wait
     // until allowed to begin
-    hsa_signal_t sig_grp_start;
-    err_ = hsa_signal_create(1, 0, NULL, &sig_grp_start);
-    ErrorCheck(err_);
+    hsa_signal_t sig_grp_start = AcquireSignal();
 
     // Bind the number of iterations
     uint32_t iterations = GetIterationNum();
 
+    // Accumulators of copy times are reused across sizes
+    std::vector<SampleAccumulator> time_accum_list(trans_cnt);
+    std::vector<SampleAccumulator> stats_accum_list(trans_cnt);
+    std::vector<std::vector<double>> raw_time_list(trans_cnt, std::vector<double>());
+    if (raw_samples_) {
+        for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
+            raw_time_list[tidx].reserve(iterations);
+        }
+    }
+
+    // Copies of a group share the Cpu timestamps of the group
+    bool export_samples = sample_writer_.IsOpen();
+    sample_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.flags_ = SAMPLE_FLAG_CONCURRENT | ((bidir) ? SAMPLE_FLAG_BIDIR : 0);
+    sample_record_t* record_ptr = (export_samples) ? &record : NULL;
+
     // Iterate through the differnt buffer sizes to
     // compute the bandwidth as determined by copy
     for (uint32_t idx = 0; idx < size_len; idx++) {
@@ -357,23 +566,28 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
         if (curr_size > max_size) {
             break;
         }
+        record.size_ = curr_size;
 
-        std::vector<std::vector<double>> gpu_time_list(trans_cnt, std::vector<double>());
+        for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
+            time_accum_list[tidx].Reset();
+            stats_accum_list[tidx].Reset();
+            raw_time_list[tidx].clear();
+        }
         for (uint32_t it = 0; it < iterations; it++) {
-            if (it % 2) {
+            if ((it % 2) && (daemon_ == false) && (embedded_ == false)) {
                 printf(".");
                 fflush(stdout);
             }
 
             // Set group trigger signal
-            hsa_signal_store_relaxed(sig_grp_start, 1);
+            transport_->StoreSignal(sig_grp_start, 1);
 
             // Update signal value to one before submitting copy requests
             uint32_t sig_idx = 0;
             uint32_t sig_cnt = sig_list.size();
             for (sig_idx = 0; sig_idx < sig_cnt; sig_idx++) {
                 signal = sig_list[sig_idx];
-                hsa_signal_store_relaxed(signal, 1);
+                transport_->StoreSignal(signal, 1);
             }
 
             // Submit copy operations in batch mode
@@ -388,16 +602,29 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
                 src_dev = dev_list[rsrc_idx + 0];
                 dst_dev = dev_list[rsrc_idx + 1];
 
-                err_ = hsa_amd_memory_async_copy(buf_dst, dst_dev, buf_src, src_dev, curr_size, 1,
-                                                 &sig_grp_start, signal);
+                err_ = transport_->CopyAsync(buf_dst, dst_dev, buf_src, src_dev, curr_size, 1,
+                                             &sig_grp_start, signal);
                 ErrorCheck(err_);
             }
 
             // Set group trigger signal
-            hsa_signal_store_relaxed(sig_grp_start, 0);
+            if (export_samples) {
+                cpu_start_ = std::chrono::steady_clock::now();
+            }
+            transport_->StoreSignal(sig_grp_start, 0);
 
             // Wait for the copy operations to complete
             WaitForCopyCompletion(sig_list);
+            if (export_samples) {
+                cpu_end_ = std::chrono::steady_clock::now();
+                record.iteration_ = it;
+                record.cpu_start_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        cpu_start_.time_since_epoch())
+                                        .count();
+                record.cpu_end_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      cpu_end_.time_since_epoch())
+                                      .count();
+            }
 
             // Retrieve times for each copy operation
             hsa_signal_t signal_rev;
@@ -405,9 +632,13 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
                 sig_idx = (bidir) ? (tidx * 2) : (tidx);
                 signal = sig_list[sig_idx + 0];
                 signal_rev = (bidir) ? (sig_list[sig_idx + 1]) : signal;
-                double temp = GetGpuCopyTime(bidir, signal, signal_rev);
-                std::vector<double>& gpu_time = gpu_time_list[tidx];
-                gpu_time.push_back(temp);
+                double temp = GetGpuCopyTime(bidir, signal, signal_rev, record_ptr);
+                AccumulateTime(it, temp, time_accum_list[tidx], stats_accum_list[tidx],
+                               raw_time_list[tidx]);
+                if (export_samples) {
+                    SetSampleEndpoints(trans_list[tidx], record);
+                    WriteSample(record);
+                }
             }
         }
 
@@ -415,21 +646,267 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
         // Get Gpu min and mean copy times
         for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
             async_trans_t& trans = trans_list[tidx];
-            std::vector<double>& gpu_time = gpu_time_list[tidx];
-            double min_time = GetMinTime(gpu_time);
-            double mean_time = GetMeanTime(gpu_time);
+            if (collect_stats_) {
+                stats_summary_t stats;
+                GetTimeStats(stats_accum_list[tidx], raw_time_list[tidx], stats);
+                trans.stats_.push_back(stats);
+            }
+            double min_time = GetMinTime(time_accum_list[tidx]);
+            double mean_time = GetMeanTime(time_accum_list[tidx]);
+            trans.size_list_.push_back(curr_size);
             trans.gpu_min_time_.push_back(min_time);
             trans.gpu_avg_time_.push_back(mean_time);
-            gpu_time.clear();
         }
     }
 
-    // Free up buffers and signal objects used in copy operation
+    // Return buffers and signal objects used in copy operation to session
     sig_list.push_back(sig_grp_start);
     ReleaseSignals(sig_list);
     ReleaseBuffers(buf_list);
 }
 
+void RocmBandwidthTest::RunCopyIterations(async_trans_t& trans, copy_rsrc_t& rsrc,
+                                          size_t max_size, size_t curr_size, double& min_time,
+                                          double& mean_time, stats_summary_t& stats) {
+    bool bidir = rsrc.bidir_;
+    bool verify = true;
+
+    // Bind the number of iterations
+    uint32_t iterations = GetIterationNum();
+
+    // Copy times are accumulated in constant memory unless
+    // user has requested raw copy times to be captured
+    SampleAccumulator time_accum;
+    SampleAccumulator stats_accum;
+    std::vector<double> raw_time;
+    if (raw_samples_) {
+        raw_time.reserve(iterations);
+    }
+
+    // Cpu timestamps are also collected when exporting samples
+    bool export_samples = sample_writer_.IsOpen();
+    bool cpu_timer = (print_cpu_time_) || (export_samples);
+    sample_record_t record;
+    memset(&record, 0, sizeof(record));
+    SetSampleEndpoints(trans, record);
+    record.size_ = curr_size;
+    record.flags_ |= (bidir) ? SAMPLE_FLAG_BIDIR : 0;
+    record.flags_ |= (print_cpu_time_) ? SAMPLE_FLAG_CPU_TIME : 0;
+    sample_record_t* record_ptr = (export_samples) ? &record : NULL;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        if ((it % 2) && (daemon_ == false) && (embedded_ == false)) {
+            printf(".");
+            fflush(stdout);
+        }
+
+        transport_->StoreSignal(rsrc.signal_fwd_, 1);
+        if (bidir) {
+            transport_->StoreSignal(rsrc.signal_rev_, 1);
+            transport_->StoreSignal(rsrc.signal_start_bidir_, 1);
+        }
+
+        // Temporary code for testing
+        if (sleep_time_ > 0) {
+            std::this_thread::sleep_for(sleep_usecs_);
+        }
+
+        // Create a timer object and start it
+        if (cpu_timer) {
+            cpu_start_ = std::chrono::steady_clock::now();
+        }
+
+        // Launch the copy operation
+        if (bidir == false) {
+            err_ = transport_->CopyAsync(rsrc.buf_dst_fwd_, rsrc.dst_agent_fwd_, rsrc.buf_src_fwd_,
+                                         rsrc.src_agent_fwd_, curr_size, 0, NULL,
+                                         rsrc.signal_fwd_);
+        } else {
+            err_ = transport_->CopyAsync(rsrc.buf_dst_fwd_, rsrc.dst_agent_fwd_, rsrc.buf_src_fwd_,
+                                         rsrc.src_agent_fwd_, curr_size, 1,
+                                         &rsrc.signal_start_bidir_, rsrc.signal_fwd_);
+        }
+        ErrorCheck(err_);
+
+        // Launch reverse copy operation if it is bidirectional
+        if (bidir) {
+            err_ = transport_->CopyAsync(rsrc.buf_dst_rev_, rsrc.dst_agent_rev_, rsrc.buf_src_rev_,
+                                         rsrc.src_agent_rev_, curr_size, 1,
+                                         &rsrc.signal_start_bidir_, rsrc.signal_rev_);
+            ErrorCheck(err_);
+        }
+
+        // Signal the bidir copies to begin
+        if (bidir) {
+            transport_->StoreSignal(rsrc.signal_start_bidir_, 0);
+        }
+
+        WaitForCopyCompletion(rsrc.signal_list_);
+
+        // Stop the timer object and extract time taken
+        if (cpu_timer) {
+            cpu_end_ = std::chrono::steady_clock::now();
+            cpu_cp_time_ = cpu_end_ - cpu_start_;
+        }
+        if (print_cpu_time_) {
+            uint64_t cpu_temp = cpu_cp_time_.count();
+            AccumulateTime(it, cpu_temp, time_accum, stats_accum, raw_time);
+        }
+
+        // Collect time from the signal(s)
+        if (print_cpu_time_ == false) {
+            if (trans.copy.uses_gpu_) {
+                double temp =
+                    GetGpuCopyTime(bidir, rsrc.signal_fwd_, rsrc.signal_rev_, record_ptr);
+                AccumulateTime(it, temp, time_accum, stats_accum, raw_time);
+            }
+        }
+
+        bool iter_verify = true;
+        if (validate_) {
+            iter_verify = ValidateDstBuffer(max_size, curr_size, rsrc.buf_dst_fwd_,
+                                            rsrc.dst_dev_idx_fwd_, rsrc.dst_agent_fwd_);
+            verify = iter_verify;
+        }
+
+        // Export copy time of the iteration
+        if (export_samples) {
+            record.iteration_ = it;
+            record.cpu_start_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    cpu_start_.time_since_epoch())
+                                    .count();
+            record.cpu_end_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  cpu_end_.time_since_epoch())
+                                  .count();
+            record.verify_status_ = (validate_ == false) ? SAMPLE_VERIFY_NONE
+                                    : (iter_verify)      ? SAMPLE_VERIFY_PASS
+                                                         : SAMPLE_VERIFY_FAIL;
+            WriteSample(record);
+        }
+    }
+
+    // Collecting Cpu or Gpu time. Capture verify failures if any
+    // Get min and mean copy times of the size
+    if ((collect_stats_) && (verify)) {
+        GetTimeStats(stats_accum, raw_time, stats);
+    }
+    min_time = (verify) ? GetMinTime(time_accum) : VALIDATE_COPY_OP_FAILURE;
+    mean_time = (verify) ? GetMeanTime(time_accum) : VALIDATE_COPY_OP_FAILURE;
+}
+
+void RocmBandwidthTest::AccumulateTime(uint32_t iter, double time, SampleAccumulator& time_accum,
+                                       SampleAccumulator& stats_accum,
+                                       std::vector<double>& raw_time) {
+    time_accum.Add(time);
+    if (collect_stats_ == false) {
+        return;
+    }
+    if (raw_samples_) {
+        raw_time.push_back(time);
+    } else if (iter > 0) {
+        stats_accum.Add(time);
+    }
+}
+
+void RocmBandwidthTest::RunAdaptiveCopySweep(async_trans_t& trans, copy_rsrc_t& rsrc,
+                                             size_t max_size) {
+    // Min and mean copy times indexed by size, kept in ascending order
+    std::map<size_t, std::pair<double, double>> time_map;
+    std::map<size_t, stats_summary_t> stats_map;
+    std::map<size_t, double> bw_map;
+
+    // Climb the size curve by doubling the buffer size. Stop once
+    // two successive doublings fail to improve the bandwidth by
+    // more than the plateau tolerance i.e. the curve is flat
+    double peak_bw = 0;
+    double prev_bw = 0;
+    uint32_t flat_cnt = 0;
+    size_t min_size = size_list_.front();
+    for (size_t curr_size = min_size; curr_size <= max_size; curr_size *= 2) {
+        double min_time = 0;
+        double mean_time = 0;
+        RunCopyIterations(trans, rsrc, max_size, curr_size, min_time, mean_time,
+                          stats_map[curr_size]);
+        time_map[curr_size] = std::make_pair(min_time, mean_time);
+
+        // A validation failure makes the rest of sweep meaningless
+        if (min_time == VALIDATE_COPY_OP_FAILURE) {
+            break;
+        }
+
+        double bw = ComputeCopyBandwidth(trans, curr_size, min_time);
+        bw_map[curr_size] = bw;
+        peak_bw = std::max(peak_bw, bw);
+        flat_cnt = ((prev_bw > 0) && (bw < prev_bw * (1 + plateau_tolerance_))) ? flat_cnt + 1 : 0;
+        if (flat_cnt == 2) {
+            break;
+        }
+        prev_bw = bw;
+    }
+
+    // Locate the first pair of measured sizes between which
+    // the bandwidth crosses knee fraction of peak bandwidth
+    double knee_bw = knee_fraction_ * peak_bw;
+    size_t lo_size = 0;
+    size_t hi_size = 0;
+    std::map<size_t, double>::iterator bw_it;
+    for (bw_it = bw_map.begin(); bw_it != bw_map.end(); bw_it++) {
+        if (bw_it->second >= knee_bw) {
+            hi_size = bw_it->first;
+            break;
+        }
+        lo_size = bw_it->first;
+    }
+
+    // Bisect the interval on a log scale so measurements are spent
+    // where the curve changes. Stop when the interval is narrower
+    // than 1/16th of its lower bound or a KB granule
+    const size_t granule = 1024;
+    while ((lo_size != 0) && (hi_size != 0) && ((hi_size - lo_size) > (lo_size / 16))) {
+        size_t mid_size = (size_t)std::sqrt((double)lo_size * (double)hi_size);
+        mid_size = (mid_size / granule) * granule;
+        if ((mid_size <= lo_size) || (mid_size >= hi_size)) {
+            break;
+        }
+
+        double min_time = 0;
+        double mean_time = 0;
+        RunCopyIterations(trans, rsrc, max_size, mid_size, min_time, mean_time,
+                          stats_map[mid_size]);
+        time_map[mid_size] = std::make_pair(min_time, mean_time);
+        if (min_time == VALIDATE_COPY_OP_FAILURE) {
+            break;
+        }
+
+        double bw = ComputeCopyBandwidth(trans, mid_size, min_time);
+        bw_map[mid_size] = bw;
+        if (bw >= knee_bw) {
+            hi_size = mid_size;
+        } else {
+            lo_size = mid_size;
+        }
+    }
+
+    // Record the knee of the curve
+    if (hi_size != 0) {
+        trans.knee_size_ = hi_size;
+        trans.knee_bandwidth_ = bw_map[hi_size];
+    }
+
+    // Record the measured sizes and their times in ascending order
+    std::vector<double>& min_list = (print_cpu_time_) ? trans.cpu_min_time_ : trans.gpu_min_time_;
+    std::vector<double>& avg_list = (print_cpu_time_) ? trans.cpu_avg_time_ : trans.gpu_avg_time_;
+    std::map<size_t, std::pair<double, double>>::iterator time_it;
+    for (time_it = time_map.begin(); time_it != time_map.end(); time_it++) {
+        trans.size_list_.push_back(time_it->first);
+        min_list.push_back(time_it->second.first);
+        avg_list.push_back(time_it->second.second);
+        if (collect_stats_) {
+            trans.stats_.push_back(stats_map[time_it->first]);
+        }
+    }
+}
+
 void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
     // Bind if this transaction is bidirectional
     bool bidir = trans.copy.bidir_;
@@ -440,13 +917,8 @@ void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
 
     // Bind to resources such as pool and agents that are involved
     // in both forward and reverse copy operations
-    void* buf_src_fwd;
-    void* buf_dst_fwd;
-    void* buf_src_rev;
-    void* buf_dst_rev;
-    hsa_signal_t signal_fwd;
-    hsa_signal_t signal_rev;
-    hsa_signal_t signal_start_bidir;
+    copy_rsrc_t rsrc = copy_rsrc_t();
+    rsrc.bidir_ = bidir;
     uint32_t src_idx = trans.copy.src_idx_;
     uint32_t dst_idx = trans.copy.dst_idx_;
     uint32_t src_dev_idx_fwd = pool_list_[src_idx].agent_index_;
@@ -457,61 +929,68 @@ void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
     hsa_amd_memory_pool_t dst_pool_fwd = trans.copy.dst_pool_;
     hsa_amd_memory_pool_t src_pool_rev = dst_pool_fwd;
     hsa_amd_memory_pool_t dst_pool_rev = src_pool_fwd;
-    hsa_agent_t src_agent_fwd = pool_list_[src_idx].owner_agent_;
-    hsa_agent_t dst_agent_fwd = pool_list_[dst_idx].owner_agent_;
-    hsa_agent_t src_agent_rev = dst_agent_fwd;
-    hsa_agent_t dst_agent_rev = src_agent_fwd;
+    rsrc.dst_dev_idx_fwd_ = dst_dev_idx_fwd;
+    rsrc.src_agent_fwd_ = pool_list_[src_idx].owner_agent_;
+    rsrc.dst_agent_fwd_ = pool_list_[dst_idx].owner_agent_;
+    rsrc.src_agent_rev_ = rsrc.dst_agent_fwd_;
+    rsrc.dst_agent_rev_ = rsrc.src_agent_fwd_;
     std::vector<void*> buffer_list;
-    std::vector<hsa_signal_t> signal_list;
+
+    // Run on NUMA node of host buffer so results don't depend on
+    // where the scheduler happened to place the process
+    cpu_set_t saved_cpus;
+    AffinityScope affinity(BindCopyThread(trans, &saved_cpus), saved_cpus);
 
     // Allocate buffers for forward path of unidirectional
     // or bidirectional copy
-    AllocateCopyBuffers(max_size, buf_src_fwd, src_pool_fwd, buf_dst_fwd, dst_pool_fwd);
+    AllocateCopyBuffers(max_size, rsrc.buf_src_fwd_, src_pool_fwd, rsrc.buf_dst_fwd_,
+                        dst_pool_fwd);
 
-    // Create a signal to wait on copy operation
-    // @TODO: replace it with a signal pool call
-    err_ = hsa_signal_create(1, 0, NULL, &signal_fwd);
-    ErrorCheck(err_);
+    // Acquire a signal to wait on copy operation
+    rsrc.signal_fwd_ = AcquireSignal();
 
     // Collect resources to be released later
-    signal_list.push_back(signal_fwd);
-    buffer_list.push_back(buf_src_fwd);
-    buffer_list.push_back(buf_dst_fwd);
+    rsrc.signal_list_.push_back(rsrc.signal_fwd_);
+    buffer_list.push_back(rsrc.buf_src_fwd_);
+    buffer_list.push_back(rsrc.buf_dst_fwd_);
 
     // Allocate buffers for reverse path of bidirectional copy
     if (bidir) {
-        AllocateCopyBuffers(max_size, buf_src_rev, src_pool_rev, buf_dst_rev, dst_pool_rev);
+        AllocateCopyBuffers(max_size, rsrc.buf_src_rev_, src_pool_rev, rsrc.buf_dst_rev_,
+                            dst_pool_rev);
 
-        // Create a signal to begin bidir copy operations
-        // @TODO: replace it with a signal pool call
-        err_ = hsa_signal_create(1, 0, NULL, &signal_rev);
-        ErrorCheck(err_);
-        err_ = hsa_signal_create(1, 0, NULL, &signal_start_bidir);
-        ErrorCheck(err_);
+        // Acquire a signal to begin bidir copy operations
+        rsrc.signal_rev_ = AcquireSignal();
+        rsrc.signal_start_bidir_ = AcquireSignal();
 
-        signal_list.push_back(signal_rev);
-        signal_list.push_back(signal_start_bidir);
-        buffer_list.push_back(buf_src_rev);
-        buffer_list.push_back(buf_dst_rev);
+        rsrc.signal_list_.push_back(rsrc.signal_rev_);
+        rsrc.signal_list_.push_back(rsrc.signal_start_bidir_);
+        buffer_list.push_back(rsrc.buf_src_rev_);
+        buffer_list.push_back(rsrc.buf_dst_rev_);
     }
 
     // Initialize source buffers with data that could be verified
-    InitializeSrcBuffer(max_size, buf_src_fwd, src_dev_idx_fwd, src_agent_fwd);
+    InitializeSrcBuffer(max_size, rsrc.buf_src_fwd_, src_dev_idx_fwd, rsrc.src_agent_fwd_);
     if (bidir) {
-        InitializeSrcBuffer(max_size, buf_src_rev, src_dev_idx_rev, src_agent_rev);
+        InitializeSrcBuffer(max_size, rsrc.buf_src_rev_, src_dev_idx_rev, rsrc.src_agent_rev_);
     }
 
     // Setup access to destination buffers for
     // both unidirectional and bidirectional copies
-    AcquirePoolAcceses(src_dev_idx_fwd, src_agent_fwd, buf_src_fwd, dst_dev_idx_fwd, dst_agent_fwd,
-                       buf_dst_fwd);
+    AcquirePoolAcceses(src_dev_idx_fwd, rsrc.src_agent_fwd_, rsrc.buf_src_fwd_, dst_dev_idx_fwd,
+                       rsrc.dst_agent_fwd_, rsrc.buf_dst_fwd_);
     if (bidir) {
-        AcquirePoolAcceses(src_dev_idx_rev, src_agent_rev, buf_src_rev, dst_dev_idx_rev,
-                           dst_agent_rev, buf_dst_rev);
+        AcquirePoolAcceses(src_dev_idx_rev, rsrc.src_agent_rev_, rsrc.buf_src_rev_,
+                           dst_dev_idx_rev, rsrc.dst_agent_rev_, rsrc.buf_dst_rev_);
     }
 
-    // Bind the number of iterations
-    uint32_t iterations = GetIterationNum();
+    // Let the adaptive sweep pick the sizes to measure
+    if (adaptive_) {
+        RunAdaptiveCopySweep(trans, rsrc, max_size);
+        ReleaseSignals(rsrc.signal_list_);
+        ReleaseBuffers(buffer_list);
+        return;
+    }
 
     // Iterate through the differnt buffer sizes to
     // compute the bandwidth as determined by copy
@@ -522,130 +1001,106 @@ void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
             break;
         }
 
-        bool verify = true;
-        std::vector<double> cpu_time;
-        std::vector<double> gpu_time;
-        for (uint32_t it = 0; it < iterations; it++) {
-            if (it % 2) {
-                printf(".");
-                fflush(stdout);
-            }
-
-            hsa_signal_store_relaxed(signal_fwd, 1);
-            if (bidir) {
-                hsa_signal_store_relaxed(signal_rev, 1);
-                hsa_signal_store_relaxed(signal_start_bidir, 1);
-            }
-
-            // Temporary code for testing
-            if (sleep_time_ > 0) {
-                std::this_thread::sleep_for(sleep_usecs_);
-            }
-
-            // Create a timer object and start it
-            if (print_cpu_time_) {
-                cpu_start_ = std::chrono::steady_clock::now();
-            }
-
-            // Launch the copy operation
-            if (bidir == false) {
-                err_ = hsa_amd_memory_async_copy(buf_dst_fwd, dst_agent_fwd, buf_src_fwd,
-                                                 src_agent_fwd, curr_size, 0, NULL, signal_fwd);
-            } else {
-                err_ = hsa_amd_memory_async_copy(buf_dst_fwd, dst_agent_fwd, buf_src_fwd,
-                                                 src_agent_fwd, curr_size, 1, &signal_start_bidir,
-                                                 signal_fwd);
-            }
-            ErrorCheck(err_);
-
-            // Launch reverse copy operation if it is bidirectional
-            if (bidir) {
-                err_ = hsa_amd_memory_async_copy(buf_dst_rev, dst_agent_rev, buf_src_rev,
-                                                 src_agent_rev, curr_size, 1, &signal_start_bidir,
-                                                 signal_rev);
-                ErrorCheck(err_);
-            }
-
-            // Signal the bidir copies to begin
-            if (bidir) {
-                hsa_signal_store_relaxed(signal_start_bidir, 0);
-            }
-
-            WaitForCopyCompletion(signal_list);
-
-            // Stop the timer object and extract time taken
-            if (print_cpu_time_) {
-                cpu_end_ = std::chrono::steady_clock::now();
-                cpu_cp_time_ = cpu_end_ - cpu_start_;
-                uint64_t cpu_temp = cpu_cp_time_.count();
-                cpu_time.push_back(cpu_temp);
-            }
-
-            // Collect time from the signal(s)
-            if (print_cpu_time_ == false) {
-                if (trans.copy.uses_gpu_) {
-                    double temp = GetGpuCopyTime(bidir, signal_fwd, signal_rev);
-                    gpu_time.push_back(temp);
-                }
-            }
-
-            if (validate_) {
-                verify = ValidateDstBuffer(max_size, curr_size, buf_dst_fwd, dst_dev_idx_fwd,
-                                           dst_agent_fwd);
-            }
-        }
-
-        // Collecting Cpu time. Capture verify failures if any
-        // Get min and mean copy times and collect them into Cpu
-        // time list
         double min_time = 0;
         double mean_time = 0;
-        if (print_cpu_time_) {
-            min_time = (verify) ? GetMinTime(cpu_time) : VALIDATE_COPY_OP_FAILURE;
-            mean_time = (verify) ? GetMeanTime(cpu_time) : VALIDATE_COPY_OP_FAILURE;
-            trans.cpu_min_time_.push_back(min_time);
-            trans.cpu_avg_time_.push_back(mean_time);
-        }
-
-        // Collecting Gpu time. Capture verify failures if any
-        // Get min and mean copy times and collect them into Gpu
-        // time list
-        if (print_cpu_time_ == false) {
-            if (trans.copy.uses_gpu_) {
-                min_time = (verify) ? GetMinTime(gpu_time) : VALIDATE_COPY_OP_FAILURE;
-                mean_time = (verify) ? GetMeanTime(gpu_time) : VALIDATE_COPY_OP_FAILURE;
-                trans.gpu_min_time_.push_back(min_time);
-                trans.gpu_avg_time_.push_back(mean_time);
-            }
+        stats_summary_t stats;
+        RunCopyIterations(trans, rsrc, max_size, curr_size, min_time, mean_time, stats);
+        trans.size_list_.push_back(curr_size);
+        if (collect_stats_) {
+            trans.stats_.push_back(stats);
         }
-        verify = true;
 
-        // Clear the stack of cpu times
+        // Collect min and mean copy times into Cpu or Gpu time list
         if (print_cpu_time_) {
-            cpu_time.clear();
+            trans.cpu_min_time_.push_back(min_time);
+            trans.cpu_avg_time_.push_back(mean_time);
+        } else {
+            trans.gpu_min_time_.push_back(min_time);
+            trans.gpu_avg_time_.push_back(mean_time);
         }
-        gpu_time.clear();
     }
 
-    // Free up buffers and signal objects used in copy operation
-    ReleaseSignals(signal_list);
+    // Return buffers and signal objects used in copy operation to session
+    ReleaseSignals(rsrc.signal_list_);
     ReleaseBuffers(buffer_list);
 }
 
 void RocmBandwidthTest::Run() {
+    // Scenarios of a plan are set up, run and displayed in turn
+    if (plan_list_.empty() == false) {
+        RunPlan();
+        return;
+    }
+
+    // Transfers of a trace are replayed as they were captured
+    if (trace_list_.empty() == false) {
+        RunTrace();
+        return;
+    }
+    RunScenario();
+}
+
+void RocmBandwidthTest::RunScenario() {
+    // Fit buffers of copies into memory of their pools
+    PlanPoolBudget();
+
+    // Dry run reports what requests need instead of running them
+    if (dry_run_) {
+        DisplayDryRun();
+        return;
+    }
+
     // Enable profiling of Async Copy Activity
     if (print_cpu_time_ == false) {
-        err_ = hsa_amd_profiling_async_copy_enable(true);
+        err_ = transport_->EnableProfiling(true);
         ErrorCheck(err_);
     }
+    ProfilingScope profiling(transport_, (print_cpu_time_ == false));
+
+    // Create file to export copy times of every iteration
+    if (sample_file_path_.empty() == false) {
+        uint64_t sys_freq = 0;
+        transport_->GetSystemInfo(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+        if (sample_writer_.Open(sample_file_path_, sys_freq) == false) {
+            std::cout << "Unable to create sample file: " << sample_file_path_ << std::endl;
+            exit_test(1);
+        }
+    }
 
+    // Run requests of user. In daemon and exporter modes results
+    // are refreshed periodically until the process is terminated
+    if (daemon_) {
+        RunDaemon();
+    }
+    RunRequests();
+    while (export_interval_ != 0) {
+        WritePrometheusReport();
+        std::this_thread::sleep_for(std::chrono::seconds(export_interval_));
+        ResetCopyResults();
+        RunRequests();
+    }
+    CloseSampleFile();
+
+    // Gpu's lower speed of their PCIe link when idle, so its state
+    // is read again while it is still trained up by the copies
+    DiscoverPcieLinks();
+
+    // Compare results with baseline before saving them as one
+    CompareBaseline();
+    SaveBaseline();
+    EvaluateHealth();
+
+    // Disable profiling of Async Copy Activity
+    err_ = profiling.Disable();
+    ErrorCheck(err_);
+}
+
+void RocmBandwidthTest::RunRequests() {
     if ((req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
         (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR)) {
         bool bidir = (req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR);
         RunConcurrentCopyBenchmark(bidir, trans_list_);
         ComputeCopyTime(trans_list_);
-        err_ = hsa_amd_profiling_async_copy_enable(false);
-        ErrorCheck(err_);
         return;
     }
 
@@ -662,25 +1117,50 @@ void RocmBandwidthTest::Run() {
             RunIOBenchmark(trans);
         }
     }
+}
 
-    // Disable profiling of Async Copy Activity
-    if (print_cpu_time_ == false) {
-        err_ = hsa_amd_profiling_async_copy_enable(false);
-        ErrorCheck(err_);
+void RocmBandwidthTest::ResetCopyResults() {
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        async_trans_t& trans = trans_list_[idx];
+        trans.cpu_avg_time_.clear();
+        trans.cpu_min_time_.clear();
+        trans.gpu_avg_time_.clear();
+        trans.gpu_min_time_.clear();
+        trans.avg_time_.clear();
+        trans.avg_bandwidth_.clear();
+        trans.min_time_.clear();
+        trans.peak_bandwidth_.clear();
+        trans.stats_.clear();
+        trans.size_list_.clear();
+        trans.knee_size_ = 0;
+        trans.knee_bandwidth_ = 0;
     }
 }
 
-void RocmBandwidthTest::Close() {
-    if (init_src_ != NULL) {
-        hsa_signal_destroy(init_signal_);
-        hsa_amd_memory_pool_free(init_src_);
+void RocmBandwidthTest::ReleaseStagingBufs() {
+    uint32_t count = staging_list_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        if (staging_list_[idx].init_src_ != NULL) {
+            transport_->Free(staging_list_[idx].init_src_);
+            staging_list_[idx].init_src_ = NULL;
+        }
+        if (staging_list_[idx].validate_dst_ != NULL) {
+            transport_->Free(staging_list_[idx].validate_dst_);
+            staging_list_[idx].validate_dst_ = NULL;
+        }
     }
+}
 
-    if (validate_) {
-        hsa_amd_memory_pool_free(validate_dst_);
+void RocmBandwidthTest::Close() {
+    if (init_signal_.handle != 0) {
+        transport_->DestroySignal(init_signal_);
     }
 
-    hsa_status_t status = hsa_shut_down();
+    ReleaseStagingBufs();
+    FreeSessionResources();
+
+    hsa_status_t status = transport_->ShutDown();
     ErrorCheck(status);
     return;
 }
@@ -699,18 +1179,23 @@ void RocmBandwidthTest::SetUp() {
     // Parse user arguments
     ParseArguments();
 
+    // Transactions of a plan are built as each scenario is run
+    if (plan_list_.empty() == false) {
+        return;
+    }
+
     // Validate input parameters
     bool status = ValidateArguments();
     if (status == false) {
         PrintHelpScreen();
-        exit(1);
+        exit_test(1);
     }
 
     // Build list of transactions (copy, read, write) to execute
     status = BuildTransList();
     if (status == false) {
         PrintHelpScreen();
-        exit(1);
+        exit_test(1);
     }
 }
 
@@ -719,19 +1204,20 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
     usr_argv_ = argv;
 
     pool_index_ = 0;
-    cpu_index_ = -1;
     agent_index_ = 0;
 
     req_read_ = REQ_INVALID;
     req_write_ = REQ_INVALID;
     req_version_ = REQ_INVALID;
     req_topology_ = REQ_INVALID;
+    req_list_devs_ = REQ_INVALID;
     req_copy_bidir_ = REQ_INVALID;
     req_copy_unidir_ = REQ_INVALID;
     req_copy_all_bidir_ = REQ_INVALID;
     req_copy_all_unidir_ = REQ_INVALID;
     req_concurrent_copy_bidir_ = REQ_INVALID;
     req_concurrent_copy_unidir_ = REQ_INVALID;
+    fan_mode_ = FAN_NONE;
 
     access_matrix_ = NULL;
     link_hops_matrix_ = NULL;
@@ -739,17 +1225,31 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
     active_agents_list_ = NULL;
     link_weight_matrix_ = NULL;
     direct_access_matrix_ = NULL;
+    access_known_ = NULL;
+    link_known_ = NULL;
 
     init_ = false;
     latency_ = false;
+    numa_ = false;
+    dry_run_ = false;
+    embedded_ = false;
+    share_src_bufs_ = false;
+    adaptive_ = false;
     validate_ = false;
+    print_stats_ = false;
     print_cpu_time_ = false;
+    collect_stats_ = false;
+    bw_raw_samples_ = getenv("ROCM_BW_RAW_SAMPLES");
+    raw_samples_ = (bw_raw_samples_ != NULL);
 
     // Set initial value to 11.231926 in case
     // user does not have a preference
     init_val_ = 11.231926;
-    init_src_ = NULL;
-    validate_dst_ = NULL;
+    init_signal_.handle = 0;
+
+    plan_index_ = 0;
+    plan_iter_cnt_ = 0;
+    trace_replay_us_ = 0;
 
     // Initialize version of the test
     version_.major_id = 2;
@@ -767,13 +1267,162 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
             std::cout << "An input value of 10 implies sleep time of 100 microseconds" << std::endl;
             std::cout << "Value of ROCM_BW_SLEEP_TIME must be between [1, 400000]" << sleep_time_
                       << std::endl;
-            exit(1);
+            exit_test(1);
         }
         sleep_time_ *= 10;
         std::chrono::microseconds temp(sleep_time_);
         sleep_usecs_ = temp;
     }
 
+    // Interval in seconds at which exporter mode refreshes results
+    export_interval_ = 0;
+    bw_export_interval_ = getenv("ROCM_BW_EXPORT_INTERVAL");
+    if (bw_export_interval_ != NULL) {
+        int32_t interval = atoi(bw_export_interval_);
+        if ((interval < 1) || (interval > 86400)) {
+            std::cout << "Value of ROCM_BW_EXPORT_INTERVAL must be between [1, 86400]: "
+                      << interval << std::endl;
+            exit_test(1);
+        }
+        export_interval_ = interval;
+    }
+
+    // Health check flags links below 90% of expected bandwidth
+    // as degraded and below 50% as failed
+    health_ = false;
+    health_degraded_ = 0.9;
+    health_fail_ = 0.5;
+    bw_health_table_ = getenv("ROCM_BW_HEALTH_TABLE");
+    bw_health_degraded_ = getenv("ROCM_BW_HEALTH_DEGRADED");
+    bw_health_fail_ = getenv("ROCM_BW_HEALTH_FAIL");
+    if (bw_health_degraded_ != NULL) {
+        health_degraded_ = atof(bw_health_degraded_);
+    }
+    if (bw_health_fail_ != NULL) {
+        health_fail_ = atof(bw_health_fail_);
+    }
+    if ((health_fail_ <= 0) || (health_degraded_ > 1) || (health_fail_ >= health_degraded_)) {
+        std::cout << "Values of ROCM_BW_HEALTH_FAIL and ROCM_BW_HEALTH_DEGRADED must satisfy "
+                  << "0 < fail < degraded <= 1: " << health_fail_ << ", " << health_degraded_
+                  << std::endl;
+        exit_test(1);
+    }
+
+    // Daemon spends 1% of time copying and keeps windows of 60 runs
+    daemon_ = false;
+    duty_cycle_ = 0.01;
+    daemon_window_ = 60;
+    bw_duty_cycle_ = getenv("ROCM_BW_DUTY_CYCLE");
+    bw_daemon_window_ = getenv("ROCM_BW_DAEMON_WINDOW");
+    bw_daemon_log_ = getenv("ROCM_BW_DAEMON_LOG");
+    if (bw_duty_cycle_ != NULL) {
+        duty_cycle_ = atof(bw_duty_cycle_);
+        if ((duty_cycle_ <= 0) || (duty_cycle_ > 1)) {
+            std::cout << "Value of ROCM_BW_DUTY_CYCLE must be in (0, 1]: " << duty_cycle_
+                      << std::endl;
+            exit_test(1);
+        }
+    }
+    if (bw_daemon_window_ != NULL) {
+        int32_t window = atoi(bw_daemon_window_);
+        if ((window < 2) || (window > 100000)) {
+            std::cout << "Value of ROCM_BW_DAEMON_WINDOW must be between [2, 100000]: " << window
+                      << std::endl;
+            exit_test(1);
+        }
+        daemon_window_ = window;
+    }
+
+    // Bandwidth may drop by 5% before it is considered a regression
+    regress_tolerance_ = 0.05;
+    bw_regress_tolerance_ = getenv("ROCM_BW_REGRESS_TOLERANCE");
+    if (bw_regress_tolerance_ != NULL) {
+        regress_tolerance_ = atof(bw_regress_tolerance_);
+        if ((regress_tolerance_ <= 0) || (regress_tolerance_ >= 1)) {
+            std::cout << "Value of ROCM_BW_REGRESS_TOLERANCE must be in (0, 1): "
+                      << regress_tolerance_ << std::endl;
+            exit_test(1);
+        }
+    }
+
+    // Knee is where bandwidth reaches 90% of its peak and the
+    // curve is flat if doubling size gains less than 2%
+    knee_fraction_ = 0.9;
+    plateau_tolerance_ = 0.02;
+    bw_knee_fraction_ = getenv("ROCM_BW_KNEE_FRACTION");
+    bw_plateau_tolerance_ = getenv("ROCM_BW_PLATEAU_TOLERANCE");
+    if (bw_knee_fraction_ != NULL) {
+        knee_fraction_ = atof(bw_knee_fraction_);
+        if ((knee_fraction_ <= 0) || (knee_fraction_ > 1)) {
+            std::cout << "Value of ROCM_BW_KNEE_FRACTION must be in (0, 1]: " << knee_fraction_
+                      << std::endl;
+            exit_test(1);
+        }
+    }
+    if (bw_plateau_tolerance_ != NULL) {
+        plateau_tolerance_ = atof(bw_plateau_tolerance_);
+        if ((plateau_tolerance_ <= 0) || (plateau_tolerance_ >= 1)) {
+            std::cout << "Value of ROCM_BW_PLATEAU_TOLERANCE must be in (0, 1): "
+                      << plateau_tolerance_ << std::endl;
+            exit_test(1);
+        }
+    }
+
+    // Copies may use up to 90% of a pool, leaving the rest to
+    // runtime and other users of device
+    pool_fraction_ = 0.9;
+    bw_pool_fraction_ = getenv("ROCM_BW_POOL_FRACTION");
+    if (bw_pool_fraction_ != NULL) {
+        pool_fraction_ = atof(bw_pool_fraction_);
+        if ((pool_fraction_ <= 0) || (pool_fraction_ > 1)) {
+            std::cout << "Value of ROCM_BW_POOL_FRACTION must be in (0, 1]: " << pool_fraction_
+                      << std::endl;
+            exit_test(1);
+        }
+    }
+
+    // Default sizes end at 512 MB unless user extends them
+    sweep_max_size_ = 0;
+    bw_sweep_max_mb_ = getenv("ROCM_BW_SWEEP_MAX_MB");
+    if (bw_sweep_max_mb_ != NULL) {
+        int32_t max_mb = atoi(bw_sweep_max_mb_);
+        if ((max_mb < 1024) || (max_mb > 1048576)) {
+            std::cout << "Value of ROCM_BW_SWEEP_MAX_MB must be between [1024, 1048576]: "
+                      << max_mb << std::endl;
+            exit_test(1);
+        }
+        sweep_max_size_ = (size_t)max_mb * 1024 * 1024;
+    }
+
+    // PCIe link state is read from sysfs, whose root can be
+    // moved to test against a fake tree
+    bw_sysfs_root_ = getenv("ROCM_BW_SYSFS_ROOT");
+    sysfs_root_ = (bw_sysfs_root_ == NULL) ? "/sys" : bw_sysfs_root_;
+
+    // Devices and copies are those of RocR unless user names a
+    // config describing devices and links to simulate
+    bw_sim_config_ = getenv("ROCM_BW_SIM_CONFIG");
+    transport_ = (bw_sim_config_ == NULL) ? CreateHsaTransport()
+                                          : CreateSimTransport(bw_sim_config_);
+
+    // Access and link matrices are cached in a file only if
+    // user names one, as links can change without a fingerprint
+    bw_topology_cache_ = getenv("ROCM_BW_TOPOLOGY_CACHE");
+
+    // Topology is discovered by one thread per hardware thread
+    // unless user specifies their number
+    bw_discovery_threads_ = getenv("ROCM_BW_DISCOVERY_THREADS");
+    discovery_threads_ = std::thread::hardware_concurrency();
+    if (bw_discovery_threads_ != NULL) {
+        int32_t num = atoi(bw_discovery_threads_);
+        if ((num < 1) || (num > 256)) {
+            std::cout << "Value of ROCM_BW_DISCOVERY_THREADS must be between [1, 256]: " << num
+                      << std::endl;
+            exit_test(1);
+        }
+        discovery_threads_ = num;
+    }
+
     bw_iter_cnt_ = getenv("ROCM_BW_ITER_CNT");
     bw_default_run_ = getenv("ROCM_BW_DEFAULT_RUN");
     bw_blocking_run_ = getenv("ROCR_BW_RUN_BLOCKING");
@@ -784,11 +1433,12 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
         int32_t num = atoi(bw_iter_cnt_);
         if (num < 0) {
             std::cout << "Value of ROCM_BW_ITER_CNT can't be negative: " << num << std::endl;
-            exit(1);
+            exit_test(1);
         }
         set_num_iteration(num);
     }
 
+    health_status_ = HEALTH_NONE;
     exit_value_ = 0;
 }
 
@@ -797,6 +1447,10 @@ RocmBandwidthTest::~RocmBandwidthTest() {
 
     if (direct_access_matrix_) delete[] direct_access_matrix_;
 
+    if (access_known_) delete[] access_known_;
+
+    if (link_known_) delete[] link_known_;
+
     if (link_hops_matrix_) delete[] link_hops_matrix_;
 
     if (link_type_matrix_) delete[] link_type_matrix_;
@@ -804,6 +1458,8 @@ RocmBandwidthTest::~RocmBandwidthTest() {
     if (link_weight_matrix_) delete[] link_weight_matrix_;
 
     if (active_agents_list_) delete[] active_agents_list_;
+
+    delete transport_;
 }
 
 std::string RocmBandwidthTest::GetVersion() const {
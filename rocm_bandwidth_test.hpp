@@ -46,8 +46,17 @@
 #include "base_test.hpp"
 #include "common.hpp"
 #include "hsa/hsa.h"
+#include "json_writer.hpp"
+#include "rocm_bandwidth.h"
+#include "sample_file.hpp"
+#include "stats.hpp"
+#include "transport.hpp"
+
+#include <pthread.h>
 
 #include <chrono>
+#include <fstream>
+#include <map>
 #include <vector>
 
 using namespace std;
@@ -68,6 +77,8 @@ typedef struct agent_info {
         char name_[64];      // Size specified in public header file
         char uuid_[24];      // Unique ID of the device
         char bdf_id_[16];    // Bus (8-bits), Device (5-bits), Function (3-bits)
+        uint32_t domain_;    // PCI domain (segment) of the device
+        uint32_t node_id_;   // Node id, that of NUMA node for Cpu's
 
 } agent_info_t;
 
@@ -152,9 +163,243 @@ typedef struct async_trans {
         vector<double> min_time_;
         vector<double> peak_bandwidth_;
 
-        async_trans(uint32_t req_type) { req_type_ = req_type; }
+        // Summary statistics of copy times, one per buffer size
+        // Collected only if user has requested statistics
+        vector<stats_summary_t> stats_;
+
+        // List of buffer sizes measured for this transaction,
+        // in ascending order. Adaptive sweeps pick their own sizes
+        vector<size_t> size_list_;
+
+        // Size at which bandwidth first reaches the knee fraction
+        // of peak bandwidth. Valid only for adaptive sweeps
+        size_t knee_size_;
+        double knee_bandwidth_;
+
+        // Index of transaction in the list of transactions
+        uint32_t trans_id_;
+
+        // Placement of host buffer relative to Gpu of the copy,
+        // one of NUMA_* values. Set only for NUMA placement runs
+        uint32_t numa_class_;
+
+        async_trans(uint32_t req_type) {
+            req_type_ = req_type;
+            trans_id_ = 0;
+            numa_class_ = 0;
+            knee_size_ = 0;
+            knee_bandwidth_ = 0;
+        }
 } async_trans_t;
 
+// Structure to encapsulate the buffers, agents and signals
+// used by forward and reverse paths of a copy transaction
+typedef struct copy_rsrc {
+        bool bidir_;
+        void* buf_src_fwd_;
+        void* buf_dst_fwd_;
+        void* buf_src_rev_;
+        void* buf_dst_rev_;
+        uint32_t dst_dev_idx_fwd_;
+        hsa_agent_t src_agent_fwd_;
+        hsa_agent_t dst_agent_fwd_;
+        hsa_agent_t src_agent_rev_;
+        hsa_agent_t dst_agent_rev_;
+        hsa_signal_t signal_fwd_;
+        hsa_signal_t signal_rev_;
+        hsa_signal_t signal_start_bidir_;
+        vector<hsa_signal_t> signal_list_;
+} copy_rsrc_t;
+
+// Structure to encapsulate a copy buffer kept by the session to be
+// reused by later copies in the same memory pool
+typedef struct cached_buf {
+        void* buf_;
+        hsa_amd_memory_pool_t pool_;
+        size_t size_;
+        bool busy_;
+} cached_buf_t;
+
+// Structure to encapsulate statistics of a copy of one size saved
+// into or read from a baseline file. Copies are identified by key
+// of its src and dst agents and the ordinal of pools in the agent
+typedef struct baseline_entry {
+        baseline_entry() {
+            size_ = 0;
+            count_ = 0;
+            tolerance_ = mean_time_ = std_dev_ = avg_bandwidth_ = peak_bandwidth_ = 0;
+        }
+
+        std::string src_key_;
+        std::string dst_key_;
+        std::string req_type_;
+        size_t size_;
+
+        // Fraction by which bandwidth may drop before it is a regression
+        double tolerance_;
+
+        // Count, mean and deviation of copy times in seconds
+        uint64_t count_;
+        double mean_time_;
+        double std_dev_;
+        double avg_bandwidth_;
+        double peak_bandwidth_;
+} baseline_entry_t;
+
+// Structure to encapsulate a rolling window of bandwidths measured
+// for a copy of one size by daemon mode. Samples are kept in a ring
+// whose capacity is fixed when the window is created
+typedef struct link_window {
+        link_window() {
+            head_ = 0;
+            count_ = 0;
+            trending_ = false;
+        }
+
+        vector<double> samples_;
+        uint32_t head_;
+        uint32_t count_;
+
+        // Set while bandwidth of the window trends downwards
+        bool trending_;
+} link_window_t;
+
+// Structure to encapsulate host buffers of a Cpu agent, allocated from
+// its system pool, used to initialize and validate copy buffers
+typedef struct staging_buf {
+        staging_buf() {
+            valid_ = false;
+            init_src_ = NULL;
+            validate_dst_ = NULL;
+        }
+
+        bool valid_;
+        hsa_agent_t agent_;
+        hsa_amd_memory_pool_t pool_;
+        void* init_src_;
+        void* validate_dst_;
+} staging_buf_t;
+
+// Structure to encapsulate time taken by one phase of topology discovery
+typedef struct discovery_phase {
+        const char* name_;
+        double time_ms_;
+} discovery_phase_t;
+
+// Structure to encapsulate state of one PCIe link as read from sysfs.
+// Speeds are in GT/s per lane, zero if kernel does not report them
+typedef struct pcie_link {
+        std::string addr_;
+        double cur_speed_;
+        uint32_t cur_width_;
+        double max_speed_;
+        uint32_t max_width_;
+} pcie_link_t;
+
+// Structure to encapsulate bandwidth expected of a class of links by
+// health check. Links are classified by type, hops and name of Gpu
+// device. Hops of 0xFFFFFFFF and name of "*" match any link
+typedef struct health_expect {
+        uint32_t link_type_;
+        uint32_t hops_;
+        std::string name_;
+        double bandwidth_;
+} health_expect_t;
+
+// Structure to encapsulate comparison of a copy with its baseline
+typedef struct baseline_diff {
+        uint32_t src_dev_idx_;
+        uint32_t dst_dev_idx_;
+        bool bidir_;
+        size_t size_;
+        double base_bandwidth_;
+        double curr_bandwidth_;
+
+        // Relative change of bandwidth and p-value of the copy
+        // being slower than its baseline
+        double change_;
+        double p_value_;
+        bool regressed_;
+} baseline_diff_t;
+
+// Structure to encapsulate one scenario of a plan file. Keys of the
+// scenario are mapped onto the command line options they stand for
+typedef struct plan_scenario {
+        plan_scenario() {
+            iter_cnt_ = 0;
+        }
+
+        std::string name_;
+        std::string mode_;
+        std::string devices_;
+        vector<std::string> args_;
+        uint32_t iter_cnt_;
+} plan_scenario_t;
+
+// Structure to encapsulate one transfer of a trace. Transfer starts
+// at a time since start of trace or when another transfer completes
+typedef struct trace_xfer {
+        trace_xfer() {
+            start_us_ = 0;
+            after_ = -1;
+            src_idx_ = dst_idx_ = 0;
+            size_ = 0;
+            duration_us_ = -1;
+            start_ = end_ = 0;
+        }
+
+        std::string id_;
+        double start_us_;
+        int32_t after_;
+        uint32_t src_idx_;
+        uint32_t dst_idx_;
+        size_t size_;
+
+        // Duration of transfer when trace was captured, negative
+        // if unknown, and timestamps of its replay
+        double duration_us_;
+        uint64_t start_;
+        uint64_t end_;
+} trace_xfer_t;
+
+// Restores affinity a thread had before its copies were bound to
+// NUMA nodes, also when an error unwinds through the copies
+class AffinityScope {
+    public:
+        AffinityScope(bool bound, const cpu_set_t& saved) : bound_(bound), saved_(saved) {}
+        ~AffinityScope() {
+            if (bound_) {
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_);
+            }
+        }
+
+    private:
+        bool bound_;
+        cpu_set_t saved_;
+};
+
+// Disables profiling of copies enabled for a scenario. Disable is
+// called when scenario completes to check its status, otherwise it
+// is disabled as an error unwinds through scenario
+class ProfilingScope {
+    public:
+        ProfilingScope(Transport* transport, bool enabled)
+            : transport_((enabled) ? transport : NULL) {}
+        ~ProfilingScope() {
+            if (transport_ != NULL) {
+                transport_->EnableProfiling(false);
+            }
+        }
+        hsa_status_t Disable() {
+            Transport* transport = transport_;
+            transport_ = NULL;
+            return (transport != NULL) ? transport->EnableProfiling(false) : HSA_STATUS_SUCCESS;
+        }
+
+    private:
+        Transport* transport_;
+};
+
 typedef enum Request_Type {
 
     REQ_READ = 1,
@@ -195,6 +440,34 @@ class RocmBandwidthTest : public BaseTest {
         // @brief: Return exit value, useful in case of error
         int32_t GetExitValue() { return exit_value_; }
 
+        // Methods below serve C API of library declared in rocm_bandwidth.h
+        // Errors unwind to the API by throwing test_exit_t
+
+        // @brief: Initialize runtime and discover topology of session
+        void OpenSession();
+
+        // @brief: Return true if test runs embedded through library API,
+        // whose calls then unwind errors instead of exiting
+        bool IsEmbedded() const { return embedded_; }
+
+        // @brief: Parse, validate and build copies of a request whose
+        // options are those of the command line
+        void SetUpRequest(const vector<std::string>& args);
+
+        // @brief: Run copies of request and compute their results
+        void RunRequest();
+
+        // @brief: Return status of request from exit value of its checks
+        rbt_status_t GetRunStatus() const;
+
+        // @brief: Query devices, links, copies and results of session
+        uint32_t GetDeviceCount() const { return pool_list_.size(); }
+        void GetDeviceInfo(uint32_t pool_idx, rbt_device_info_t& info) const;
+        void GetLinkInfo(uint32_t src_idx, uint32_t dst_idx, rbt_link_info_t& info) const;
+        uint32_t GetTransCount() const { return trans_list_.size(); }
+        void GetTransInfo(uint32_t trans_idx, rbt_transaction_info_t& info) const;
+        bool GetResult(uint32_t trans_idx, uint32_t result_idx, rbt_result_t& result) const;
+
     private:
         // @brief: Print Help Menu Screen
         void PrintHelpScreen();
@@ -204,10 +477,34 @@ class RocmBandwidthTest : public BaseTest {
 
         // @brief: Populate link properties for the set of agents
         void DiscoverLinkProps();
-        void BindLinkProps(uint32_t idx1, uint32_t idx2);
+        void DiscoverLinkRows(uint32_t first, uint32_t stride);
+        void BindLinkProps(uint32_t idx1, uint32_t idx2,
+                           vector<hsa_amd_memory_pool_link_info_t>& link_info) const;
+
+        // @brief: Return a link property, or access path when key is
+        // LINK_PROP_PATH, of two agents. Cell is discovered on first use
+        uint32_t GetLinkProp(uint32_t key, uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
 
         // @brief: Populates the access matrix
         void PopulateAccessMatrix();
+        void PopulateAccessRows(uint32_t first, uint32_t stride);
+        void PopulateAccessCell(uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
+
+        // @brief: Run a discovery method on several threads, each one
+        // handling rows of agents first, first + stride and so on
+        void RunDiscoveryThreads(void (RocmBandwidthTest::*rows)(uint32_t, uint32_t));
+
+        // @brief: Body of a discovery thread, which saves exit value
+        // of an error instead of exiting
+        void RunDiscoveryWorker(void (RocmBandwidthTest::*rows)(uint32_t, uint32_t),
+                                uint32_t first, uint32_t stride, int32_t* exit_value);
+
+        // @brief: Record time elapsed since start as a discovery phase
+        // and restart the clock for the next phase
+        void RecordDiscoveryPhase(const char* name, std::chrono::steady_clock::time_point& start);
+
+        // @brief: Print time taken by each phase of topology discovery
+        void PrintDiscoveryTime() const;
 
         // @brief: Print topology info
         void PrintTopology();
@@ -227,8 +524,19 @@ class RocmBandwidthTest : public BaseTest {
         // build list of transactions
         void ParseArguments();
 
+        // @brief: Parse options of user or of a plan scenario. Returns
+        // false if help screen is requested or an option is illegal
+        bool ParseOptions(uint32_t& num_primary_flags, uint32_t& copy_mask,
+                          uint32_t& copy_ctrl_mask);
+
+        // @brief: Check secondary options are consistent with each other
+        void CheckOptions();
+
+        // @brief: Build lists of devices and buffer sizes of request
+        void BuildRequestLists();
+
         // @brief Validate user input of primary operations
-        void ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask, uint32_t copy_ctrl_mask);
+        bool ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask, uint32_t copy_ctrl_mask);
 
         // @brief: Print the list of transactions
         void PrintTransList();
@@ -239,17 +547,75 @@ class RocmBandwidthTest : public BaseTest {
         // @brief: Run copy requests of users
         void RunCopyBenchmark(async_trans_t& trans);
 
+        // @brief: Run the iterations of a copy request for one buffer
+        // size and return the min and mean of the times measured
+        void RunCopyIterations(async_trans_t& trans, copy_rsrc_t& rsrc, size_t max_size,
+                               size_t curr_size, double& min_time, double& mean_time,
+                               stats_summary_t& stats);
+
+        // @brief: Run copy request on sizes picked adaptively to locate
+        // the size where bandwidth reaches knee fraction of its peak
+        void RunAdaptiveCopySweep(async_trans_t& trans, copy_rsrc_t& rsrc, size_t max_size);
+
         // @brief: Run copy requests of users
         void RunConcurrentCopyBenchmark(bool bidir, vector<async_trans_t>& trans_list);
 
+        // @brief: Run requests of user or of a plan scenario
+        void RunScenario();
+
+        // @brief: Run all requests of user once
+        void RunRequests();
+
+        // @brief: Discard results of copy requests before running them again
+        void ResetCopyResults();
+
         // @brief: Get iteration number
         uint32_t GetIterationNum();
 
+        // @brief: Accumulate copy time of an iteration. Copy times
+        // of iterations following the first one are accumulated for
+        // statistics and are captured raw only if user requested so
+        void AccumulateTime(uint32_t iter, double time, SampleAccumulator& time_accum,
+                            SampleAccumulator& stats_accum, vector<double>& raw_time);
+
         // @brief: Get the mean copy time
-        double GetMeanTime(vector<double>& vec);
+        double GetMeanTime(const SampleAccumulator& accum);
 
         // @brief: Get the min copy time
-        double GetMinTime(vector<double>& vec);
+        double GetMinTime(const SampleAccumulator& accum);
+
+        // @brief: Get summary statistics of copy times, excluding
+        // the first iteration which warms up the copy path. Uses
+        // raw copy times if they were captured
+        void GetTimeStats(const SampleAccumulator& accum, const vector<double>& raw_time,
+                          stats_summary_t& stats);
+
+        // @brief: Write topology, link properties and results of
+        // copy requests as a JSON document into file of user
+        void WriteJsonReport() const;
+        void WriteJsonTopology(JsonWriter& json) const;
+        void WriteJsonLinks(JsonWriter& json) const;
+
+        // @brief: Emit a value of link property, null if not applicable
+        void WriteJsonLinkValue(JsonWriter& json, uint32_t key, uint32_t value) const;
+
+        // @brief: Write results of copy requests in Prometheus text
+        // format into textfile collector directory of user. File is
+        // replaced atomically so collector never reads a partial one
+        void WritePrometheusReport() const;
+        void WritePrometheusLabels(std::ostream& out, const async_trans_t& trans,
+                                   size_t size) const;
+        void WriteJsonTrans(JsonWriter& json, const async_trans_t& trans) const;
+
+        // @brief: Write agents and links between them as a graph into
+        // file of user, in GraphML format if file name ends with
+        // .graphml and in DOT format otherwise. Links are annotated
+        // with peak bandwidth of unidirectional copies if any ran
+        void WriteGraphReport() const;
+        void WriteGraphDot(std::ostream& out, const vector<double>& bw_matrix) const;
+        void WriteGraphML(std::ostream& out, const vector<double>& bw_matrix) const;
+        void PopulateGraphBandwidth(vector<double>& bw_matrix) const;
+        const char* GetGraphLinkType(uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
 
         // @brief: Dispaly Benchmark result
         void PopulatePerfMatrix(bool peak, double* perf_matrix) const;
@@ -257,6 +623,11 @@ class RocmBandwidthTest : public BaseTest {
         void DisplayDevInfo() const;
         void DisplayIOTime(async_trans_t& trans) const;
         void DisplayCopyTime(async_trans_t& trans) const;
+        void DisplayFanTime() const;
+        void DisplayCopyStats(const async_trans_t& trans) const;
+        void DisplayCopyStatsList() const;
+        void DisplayBaselineDiff() const;
+        void DisplayHealthMatrix() const;
         void DisplayCopyTimeMatrix(bool peak) const;
         void DisplayValidationMatrix() const;
 
@@ -267,14 +638,15 @@ class RocmBandwidthTest : public BaseTest {
         bool ValidateWriteReq();
         bool ValidateReadOrWriteReq(vector<size_t>& in_list);
 
-        void ValidateCopyBidirFlags(uint32_t copy_ctrl_mask);
-        void ValidateCopyAllBidirFlags(uint32_t copy_ctrl_mask);
-        void ValidateCopyAllUnidirFlags(uint32_t copy_ctrl_mask);
-        void ValidateCopyUnidirFlags(uint32_t copy_mask, uint32_t copy_ctrl_mask);
+        bool ValidateCopyBidirFlags(uint32_t copy_ctrl_mask);
+        bool ValidateCopyAllBidirFlags(uint32_t copy_ctrl_mask);
+        bool ValidateCopyAllUnidirFlags(uint32_t copy_ctrl_mask);
+        bool ValidateCopyUnidirFlags(uint32_t copy_mask, uint32_t copy_ctrl_mask);
 
         bool ValidateBidirCopyReq();
         bool ValidateUnidirCopyReq();
         bool ValidateConcurrentCopyReq();
+        bool ValidateFanCopyReq();
         bool ValidateCopyReq(vector<size_t>& in_list);
         void PrintIOAccessError(uint32_t agent_idx, uint32_t pool_idx);
         void PrintCopyAccessError(uint32_t src_pool_idx, uint32_t dst_pool_idx);
@@ -282,6 +654,10 @@ class RocmBandwidthTest : public BaseTest {
         bool PoolIsPresent(vector<size_t>& in_list);
         bool PoolIsDuplicated(vector<size_t>& in_list);
 
+        // @brief: Compute bandwidth in GB/s of copying a buffer of size
+        // in time, which is in units of Cpu or Gpu timer as applicable
+        double ComputeCopyBandwidth(async_trans_t& trans, size_t size, double time);
+
         // @brief: Builds a list of transaction per user request
         void ComputeCopyTime(async_trans_t& trans);
         void ComputeCopyTime(vector<async_trans_t>& trans_list);
@@ -297,6 +673,7 @@ class RocmBandwidthTest : public BaseTest {
         bool BuildReadOrWriteTrans(uint32_t req_type, vector<size_t>& in_list);
         bool BuildCopyTrans(uint32_t req_type, vector<size_t>& src_list, vector<size_t>& dst_list);
         bool BuildConcurrentCopyTrans(uint32_t req_type, vector<size_t>& dev_list);
+        bool BuildFanCopyTrans();
 
         void WaitForCopyCompletion(vector<hsa_signal_t>& signal_list);
 
@@ -310,10 +687,42 @@ class RocmBandwidthTest : public BaseTest {
                                              vector<hsa_signal_t>& sig_list,
                                              vector<hsa_amd_memory_pool_t>& pool_list);
 
+        // @brief: Buffers and signals of copies are kept by the session
+        // until its scenario is done, so later copies reuse them instead
+        // of allocating their own. Release returns them to the session
+        void* AcquireBuffer(hsa_amd_memory_pool_t pool, size_t size);
+        hsa_signal_t AcquireSignal();
         void ReleaseBuffers(vector<void*>& buffer_list);
         void ReleaseSignals(vector<hsa_signal_t>& signal_list);
 
-        double GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd, hsa_signal_t signal_rev);
+        // @brief: Free buffers and signals kept by the session
+        void FreeSessionResources();
+
+        // @brief: Get time taken by copy from its signals. Gpu ticks
+        // are saved into record if one is passed in
+        double GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd, hsa_signal_t signal_rev,
+                              sample_record_t* record = NULL);
+
+        // @brief: Record transaction and endpoints of copy in record
+        void SetSampleEndpoints(const async_trans_t& trans, sample_record_t& record) const;
+
+        // @brief: Append a record to the sample file if user has
+        // requested copy times of every iteration to be exported
+        void WriteSample(sample_record_t& record);
+
+        // @brief: Flush and close the sample file if one is open
+        void CloseSampleFile();
+
+        // @brief: Return host buffers of Cpu agent nearest to a device,
+        // which is the agent itself if device is a Cpu
+        staging_buf_t& GetStagingBuf(size_t size, uint32_t dev_idx);
+
+        // @brief: Return Cpu agent nearest to a device that has a system
+        // pool to stage its host buffers, -1 if there is none
+        int32_t GetStagingAgent(uint32_t dev_idx) const;
+
+        // @brief: Free host buffers used to initialize and validate copies
+        void ReleaseStagingBufs();
 
         void InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t cpy_dev_idx,
                                  hsa_agent_t cpy_agent);
@@ -394,6 +803,16 @@ class RocmBandwidthTest : public BaseTest {
         // reported by the system
         vector<size_t> bidir_list_;
 
+        // List of devices in a fan-out or fan-in copy operation. First
+        // device is the one copies leave from or arrive at
+        vector<size_t> fan_list_;
+
+        // Determines if concurrent copies fan out of or into a device
+        uint32_t fan_mode_;
+        static const uint32_t FAN_NONE = 0x00;
+        static const uint32_t FAN_OUT = 0x01;
+        static const uint32_t FAN_IN = 0x02;
+
         // List of source agents in a unidrectional copy operation
         // Size of the list cannot exceed the number of agents
         // reported by the system
@@ -439,6 +858,7 @@ class RocmBandwidthTest : public BaseTest {
         static const uint32_t CPU_VISIBLE_TIME = 0x04;
         static const uint32_t DEV_COPY_LATENCY = 0x08;
         static const uint32_t VALIDATE_COPY_OP = 0x010;
+        static const uint32_t ADAPTIVE_SWEEP = 0x020;
 
         static const uint32_t LINK_TYPE_SELF = 0x00;
         static const uint32_t LINK_TYPE_PCIE = 0x01;
@@ -451,6 +871,9 @@ class RocmBandwidthTest : public BaseTest {
         static const uint32_t LINK_PROP_WEIGHT = 0x02;
         static const uint32_t LINK_PROP_ACCESS = 0x03;
 
+        // Access inferred from either direction, used to build copies
+        static const uint32_t LINK_PROP_PATH = 0x04;
+
         // Encodes validation failure
         static const double VALIDATE_COPY_OP_FAILURE;
 
@@ -467,6 +890,11 @@ class RocmBandwidthTest : public BaseTest {
         uint32_t* link_weight_matrix_;
         uint32_t* direct_access_matrix_;
 
+        // Determine if a cell of access matrices or of link matrices
+        // has been discovered, as cells are discovered on first use
+        uint8_t* access_known_;
+        uint8_t* link_known_;
+
         // Env key to determine if Fine-grained or
         // Coarse-grained pool should be filtered out
         char* skip_cpu_fine_grain_;
@@ -497,6 +925,323 @@ class RocmBandwidthTest : public BaseTest {
         // Flag to print Cpu time
         bool print_cpu_time_;
 
+        // Flag to collect and print statistics such as percentiles,
+        // deviation, confidence interval and histogram of copy times
+        bool print_stats_;
+
+        // Env key to capture raw copy times for exact statistics
+        // instead of summarizing them in constant memory
+        char* bw_raw_samples_;
+        bool raw_samples_;
+
+        // File into which copy times of every iteration are exported
+        std::string sample_file_path_;
+        SampleFileWriter sample_writer_;
+
+        // @brief: Return key identifying an agent across runs. Gpu is
+        // identified by its Uuid, or Bdf if it lacks one, and Cpu by
+        // its ordinal among Cpu agents
+        std::string GetAgentKey(uint32_t dev_idx) const;
+
+        // @brief: Return ordinal of a pool among pools of its agent
+        uint32_t GetPoolOrdinal(uint32_t pool_idx) const;
+
+        // @brief: Build baseline entry of a copy of one size
+        void BuildBaselineEntry(const async_trans_t& trans, uint32_t size_idx,
+                                baseline_entry_t& entry) const;
+
+        // @brief: Save results of copy requests into baseline file
+        void SaveBaseline() const;
+
+        // @brief: Read entries of baseline file of user keyed by copy,
+        // and return key of a copy of one size in such file
+        void LoadBaseline(std::map<std::string, baseline_entry_t>& base_map) const;
+        std::string GetBaselineKey(const async_trans_t& trans, size_t size) const;
+
+        // @brief: Compare results of copy requests with baseline
+        // file and set exit value if any of them regressed
+        void CompareBaseline();
+
+        // @brief: Run requests of user periodically at a capped duty
+        // cycle, keeping rolling windows of bandwidth per link and
+        // logging drops and trends. Runs until process is terminated
+        void RunDaemon();
+
+        // @brief: Add results of a run to the rolling windows and
+        // log bandwidths that dropped or windows that trend down
+        void UpdateDaemonWindows();
+
+        // @brief: Log a summary of the rolling windows
+        void LogDaemonSummary();
+
+        // @brief: Return stream of daemon log with a timestamp written
+        std::ostream& DaemonLog();
+
+        // @brief: Return description of a copy used in daemon log
+        std::string GetDaemonLinkString(const async_trans_t& trans, size_t size) const;
+
+        // @brief: Load table of expected bandwidths of health check
+        // from file of user, or the built-in one if none is specified
+        void LoadHealthTable();
+
+        // @brief: Return bandwidth expected of link between two agents
+        // by health check, zero if no entry of table matches the link
+        double GetExpectedBandwidth(uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
+
+        // @brief: Grade bandwidth of every copy of health check against
+        // its expected bandwidth and set exit value if any fell short
+        void EvaluateHealth();
+
+        // Determines if user has requested health check, and env keys
+        // to specify table of expected bandwidths and the fractions of
+        // expected bandwidth below which a link is degraded or failed
+        bool health_;
+        char* bw_health_table_;
+        char* bw_health_degraded_;
+        char* bw_health_fail_;
+        double health_degraded_;
+        double health_fail_;
+        vector<health_expect_t> health_table_;
+
+        // Grade and expected bandwidth of links, indexed by agents
+        vector<uint32_t> health_grade_;
+        vector<double> health_expected_;
+
+        // Grades of a link by health check
+        static const uint32_t HEALTH_NONE = 0x00;
+        static const uint32_t HEALTH_PASS = 0x01;
+        static const uint32_t HEALTH_DEGRADED = 0x02;
+        static const uint32_t HEALTH_FAIL = 0x03;
+
+        // Exit values returned when a link is degraded or failed
+        static const int32_t HEALTH_DEGRADED_EXIT_VALUE = 3;
+        static const int32_t HEALTH_FAIL_EXIT_VALUE = 4;
+
+        // Worst grade of links checked by last health check,
+        // independent of exit value which other checks also set
+        uint32_t health_status_;
+
+        // Number of iterations run by health check by default
+        static const uint32_t HEALTH_ITER_CNT = 5;
+
+        // @brief: Return fingerprint of discovered agents and pools,
+        // runtime and driver versions and env keys filtering pools
+        uint64_t GetTopologyFingerprint() const;
+
+        // @brief: Load access and link matrices from topology cache,
+        // returns false if cache is absent or built for other topology
+        bool LoadTopologyCache(uint64_t fingerprint);
+
+        // @brief: Save access and link matrices into topology cache
+        void SaveTopologyCache(uint64_t fingerprint) const;
+
+        // Env key to specify file caching access and link matrices
+        char* bw_topology_cache_;
+
+        // Env key to specify number of threads discovering topology,
+        // and time taken by each phase of discovery in order
+        char* bw_discovery_threads_;
+        uint32_t discovery_threads_;
+        vector<discovery_phase_t> discovery_phases_;
+
+        // @brief: Read state of PCIe links of every Gpu and of bridges
+        // upstream of it from sysfs
+        void DiscoverPcieLinks();
+
+        // @brief: Return theoretical bandwidth in GB/s of the narrowest
+        // link on PCIe path of a Gpu, at current or at maximum link state
+        double GetPcieBandwidth(uint32_t dev_idx, bool max) const;
+
+        // @brief: Write PCIe links of a Gpu in JSON format
+        void WriteJsonPcieLinks(JsonWriter& json, uint32_t dev_idx) const;
+
+        // @brief: Print PCIe link state of Gpu's and measured efficiency
+        // of copies between Cpu and Gpu devices
+        void DisplayPcieLinkInfo() const;
+        void DisplayPcieEfficiency() const;
+
+        // Env key to specify root of sysfs, and PCIe links of each agent
+        // indexed by agent. First link is that of device, followed by
+        // links of bridges upstream of it. Empty for Cpu agents
+        char* bw_sysfs_root_;
+        std::string sysfs_root_;
+        vector<vector<pcie_link_t>> pcie_links_;
+
+        // @brief: Read list of Cpu's of NUMA node of every Cpu agent
+        void DiscoverNumaNodes();
+
+        // @brief: Return index of Cpu agent nearest to or farthest from
+        // a Gpu by NUMA distance, -1 if system has no Cpu agent
+        int32_t GetNumaCpu(uint32_t gpu_dev_idx, bool far) const;
+
+        // @brief: Build copies between every Gpu and its nearest and
+        // farthest Cpu agents to compare placement of host buffers
+        bool BuildNumaCopyTrans();
+
+        // @brief: Return index of Cpu agent of NUMA node holding host
+        // buffer of a copy, or nearest to its Gpu if it has none
+        int32_t GetCopyNumaCpu(const async_trans_t& trans) const;
+
+        // @brief: Bind calling thread to Cpu's of NUMA nodes of listed
+        // Cpu agents. Returns true if thread was bound, saving its
+        // previous affinity
+        bool BindThreadToNodes(const vector<int32_t>& cpu_dev_list, cpu_set_t* saved);
+
+        // @brief: Bind calling thread to Cpu's of NUMA node holding host
+        // buffer of a copy, or nearest to its Gpu if it has none, or to
+        // those of all copies of a concurrent group
+        bool BindCopyThread(const async_trans_t& trans, cpu_set_t* saved);
+        bool BindCopyThread(const vector<async_trans_t>& trans_list, cpu_set_t* saved);
+
+        // @brief: Print bandwidth of copies with near and far host buffers
+        void DisplayNumaMatrix() const;
+
+        // Determines if user has requested comparison of near and far
+        // host buffers, and Cpu's of NUMA node of each agent indexed
+        // by agent. Empty for Gpu agents and nodes sysfs does not list
+        bool numa_;
+        vector<vector<uint32_t>> numa_cpus_;
+
+        // Placement of host buffer of a copy relative to its Gpu
+        static const uint32_t NUMA_NONE = 0x00;
+        static const uint32_t NUMA_NEAR = 0x01;
+        static const uint32_t NUMA_FAR = 0x02;
+
+        // @brief: Sum bytes each pool needs to run copy requests, indexed
+        // by pool. Copies that run one after another reuse buffers of
+        // session, so a pool needs as much as the largest of them, while
+        // concurrent copies need their sum. Host buffers that stage
+        // initialization and validation are included
+        void GetPoolDemand(vector<size_t>& demand) const;
+
+        // @brief: Fit buffers of copy requests into budget of each pool,
+        // first by letting concurrent copies share source buffers of a
+        // pool and then by capping the largest size. Adjustments are
+        // reported to user
+        void PlanPoolBudget();
+
+        // Env key to specify fraction of a pool copies may use, and if
+        // concurrent copies from a pool share one source buffer
+        char* bw_pool_fraction_;
+        double pool_fraction_;
+        bool share_src_bufs_;
+
+        // @brief: Return bandwidth in GB/s expected of copy of a size,
+        // as measured by baseline if it has the copy or else by priors
+        // of its link class. Returns zero if neither has one
+        double GetEstimatedBandwidth(const async_trans_t& trans, size_t size,
+                                     const std::map<std::string, baseline_entry_t>& base_map,
+                                     bool& from_baseline) const;
+
+        // @brief: Print copies, bytes they move, memory each pool needs
+        // and estimated runtime instead of running the copies
+        void DisplayDryRun();
+
+        // Determines if user has requested a dry run, and exit value
+        // returned if a pool can't hold buffers of copies
+        bool dry_run_;
+        static const int32_t DRY_RUN_EXIT_VALUE = 5;
+
+        // @brief: Load scenarios of plan file named by user
+        void LoadPlan();
+
+        // @brief: Load scenarios of default run, which copies among all
+        // devices unidirectionally and then bidirectionally
+        void LoadDefaultPlan();
+
+        // @brief: Run scenarios of plan file in turn, setting up each
+        // one from its options and displaying its results. Runtime is
+        // initialized and topology discovered once for all of them
+        void RunPlan();
+        void SetUpScenario(const plan_scenario_t& scenario);
+
+        // @brief: Clear requests and options of previous scenario
+        void ResetScenario();
+
+        // @brief: Determine if any scenario of plan copies among all
+        // devices, which calls for discovering topology eagerly
+        bool PlanCopiesAllDevices() const;
+
+        // File of scenarios to run, their list, index of the one being
+        // run and number of iterations of scenarios that specify none
+        std::string plan_file_path_;
+        vector<plan_scenario_t> plan_list_;
+        uint32_t plan_index_;
+        uint32_t plan_iter_cnt_;
+        vector<char*> plan_argv_;
+
+        // @brief: Load transfers of trace file named by user
+        void LoadTrace();
+
+        // @brief: Determine transfers of trace are between pools that
+        // exist and have a path between them
+        void ValidateTrace();
+
+        // @brief: Replay transfers of trace with their timing and
+        // dependencies, and print time taken against time of trace
+        // and utilization of each link
+        void RunTrace();
+        void DisplayTrace() const;
+
+        // File of transfers to replay, their list and time taken
+        // by replay in microseconds
+        std::string trace_file_path_;
+        vector<trace_xfer_t> trace_list_;
+        double trace_replay_us_;
+
+        // Determines if test is embedded in a process by library API
+        bool embedded_;
+
+        // Transport through which devices are discovered and copies are
+        // run, and env key to specify config of simulated transport
+        Transport* transport_;
+        char* bw_sim_config_;
+
+        // Determines if tests run as a daemon, and env keys to specify
+        // its duty cycle, number of runs in its rolling windows and its
+        // log file. Log is written to stdout if no file is specified
+        bool daemon_;
+        char* bw_duty_cycle_;
+        char* bw_daemon_window_;
+        char* bw_daemon_log_;
+        double duty_cycle_;
+        uint32_t daemon_window_;
+        std::ofstream daemon_log_;
+
+        // Rolling windows indexed by transaction and size
+        vector<std::map<size_t, link_window_t>> daemon_windows_;
+
+        // Files into which results are saved as baseline and
+        // from which baseline is read to compare results with
+        std::string baseline_save_path_;
+        std::string baseline_cmp_path_;
+        vector<baseline_diff_t> baseline_diff_list_;
+
+        // Env key to specify fraction by which bandwidth may drop
+        // before it is considered a regression
+        char* bw_regress_tolerance_;
+        double regress_tolerance_;
+
+        // Exit value returned when a copy regressed against baseline
+        static const int32_t REGRESSION_EXIT_VALUE = 2;
+
+        // Statistics are collected if user requested them or
+        // needs them to save or compare against a baseline
+        bool collect_stats_;
+
+        // File into which results are written in JSON format
+        std::string json_file_path_;
+
+        // File into which topology is written as a DOT or GraphML graph
+        std::string graph_file_path_;
+
+        // Textfile collector directory into which results are written
+        // in Prometheus format, and env key to specify the interval in
+        // seconds at which they are refreshed by exporter mode
+        std::string prom_dir_path_;
+        char* bw_export_interval_;
+        uint32_t export_interval_;
+
         // Determines if user has requested initialization
         bool init_;
 
@@ -504,24 +1249,48 @@ class RocmBandwidthTest : public BaseTest {
         bool validate_;
         long double init_val_;
 
-        // Handles to buffer used to initialize and validate
-        void* init_src_;
-        void* validate_dst_;
+        // Buffers used to initialize and validate, indexed by agent.
+        // Each Cpu agent stages buffers of devices nearest to it
+        vector<staging_buf_t> staging_list_;
+
+        // Copy buffers and idle signals kept by the session
+        vector<cached_buf_t> buf_cache_;
+        vector<hsa_signal_t> signal_cache_;
         hsa_signal_t init_signal_;
 
         // Determines the latency overhead of copy operations
         bool latency_;
 
-        // CPU agent used for validation
-        int32_t cpu_index_;
-        hsa_agent_t cpu_agent_;
+        // Determines if buffer sizes are picked adaptively to locate
+        // the knee of bandwidth curve instead of walking the size list
+        bool adaptive_;
 
-        // System region
-        hsa_amd_memory_pool_t sys_pool_;
+        // Env keys to specify fraction of peak bandwidth that defines
+        // the knee and the relative gain below which the curve is flat
+        char* bw_knee_fraction_;
+        char* bw_plateau_tolerance_;
+        double knee_fraction_;
+        double plateau_tolerance_;
 
         static const size_t SIZE_LIST[20];
         static const size_t LATENCY_SIZE_LIST[20];
 
+        // Env key to specify largest size in megabytes that list of
+        // default sizes is doubled up to beyond its last size
+        char* bw_sweep_max_mb_;
+        size_t sweep_max_size_;
+
+        // Size of chunk of initialization buffer whose pattern is
+        // replicated over the rest of buffer
+        static const size_t INIT_CHUNK_SIZE = (64 * 1024 * 1024);
+
+        // @brief: Set exit value unless one of higher rank is set.
+        // Ranks from highest are: failed validation, failed link,
+        // degraded link, regression against baseline and dry run
+        // that does not fit into memory
+        void RaiseExitValue(int32_t value);
+        uint32_t GetExitRank(int32_t value) const;
+
         // Exit value to return in case of error
         int32_t exit_value_;
 };
@@ -0,0 +1,341 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth.h"
+#include "rocm_bandwidth_test.hpp"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+void RocmBandwidthTest::OpenSession() {
+    embedded_ = true;
+    err_ = transport_->Init();
+    ErrorCheck(err_);
+    DiscoverTopology();
+}
+
+void RocmBandwidthTest::SetUpRequest(const vector<std::string>& args) {
+    plan_scenario_t scenario;
+    scenario.name_ = "request";
+    scenario.args_ = args;
+    scenario.iter_cnt_ = 0;
+    SetUpScenario(scenario);
+
+    // Requests run once and return, so none that run until the
+    // process is terminated or that bring their own requests
+    if ((daemon_) || (export_interval_ != 0) || (plan_file_path_.empty() == false) ||
+        (trace_file_path_.empty() == false)) {
+        std::cout << "Options -D, -f, -T and exporter mode can't be used by library"
+                  << std::endl;
+        exit_test(1);
+    }
+    if (trans_list_.empty()) {
+        std::cout << "Options of request build no copies" << std::endl;
+        exit_test(1);
+    }
+}
+
+void RocmBandwidthTest::RunRequest() {
+    exit_value_ = 0;
+    RunScenario();
+}
+
+rbt_status_t RocmBandwidthTest::GetRunStatus() const {
+    switch (exit_value_) {
+        case 0:
+            return RBT_STATUS_SUCCESS;
+        case DRY_RUN_EXIT_VALUE:
+            return RBT_STATUS_POOL_TOO_SMALL;
+        case REGRESSION_EXIT_VALUE:
+            return RBT_STATUS_REGRESSION;
+        case HEALTH_DEGRADED_EXIT_VALUE:
+            return RBT_STATUS_LINK_DEGRADED;
+        case HEALTH_FAIL_EXIT_VALUE:
+            return RBT_STATUS_LINK_FAILED;
+        default:
+            return RBT_STATUS_VALIDATION_FAILED;
+    }
+}
+
+void RocmBandwidthTest::GetDeviceInfo(uint32_t pool_idx, rbt_device_info_t& info) const {
+    const pool_info_t& pool = pool_list_[pool_idx];
+    const agent_info_t& agent = agent_list_[pool.agent_index_];
+    memset(&info, 0, sizeof(info));
+    info.device_id = pool_idx;
+    info.agent_index = pool.agent_index_;
+    info.type = (agent.device_type_ == HSA_DEVICE_TYPE_GPU) ? RBT_DEVICE_TYPE_GPU
+                                                            : RBT_DEVICE_TYPE_CPU;
+    memcpy(info.name, agent.name_, (sizeof(info.name) - 1));
+    memcpy(info.bdf_id, agent.bdf_id_, (sizeof(info.bdf_id) - 1));
+    info.allocable_size = pool.allocable_size_;
+    info.fine_grained = pool.is_fine_grained_;
+}
+
+void RocmBandwidthTest::GetLinkInfo(uint32_t src_idx, uint32_t dst_idx,
+                                    rbt_link_info_t& info) const {
+    uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
+    memset(&info, 0, sizeof(info));
+    info.path_exists = (GetLinkProp(LINK_PROP_PATH, src_dev_idx, dst_dev_idx) != 0);
+    if (src_dev_idx == dst_dev_idx) {
+        info.type = RBT_LINK_TYPE_SELF;
+        return;
+    }
+    info.hops = GetLinkProp(LINK_PROP_HOPS, src_dev_idx, dst_dev_idx);
+    info.weight = GetLinkProp(LINK_PROP_WEIGHT, src_dev_idx, dst_dev_idx);
+    switch (GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx)) {
+        case LINK_TYPE_PCIE:
+            info.type = RBT_LINK_TYPE_PCIE;
+            break;
+        case LINK_TYPE_XGMI:
+            info.type = RBT_LINK_TYPE_XGMI;
+            break;
+        case LINK_TYPE_NO_PATH:
+            info.type = RBT_LINK_TYPE_NO_PATH;
+            break;
+        default:
+            info.type = RBT_LINK_TYPE_OTHER;
+            break;
+    }
+}
+
+void RocmBandwidthTest::GetTransInfo(uint32_t trans_idx, rbt_transaction_info_t& info) const {
+    const async_trans_t& trans = trans_list_[trans_idx];
+    memset(&info, 0, sizeof(info));
+    info.src_device_id = trans.copy.src_idx_;
+    info.dst_device_id = trans.copy.dst_idx_;
+    info.bidir = trans.copy.bidir_;
+    info.result_count = trans.avg_bandwidth_.size();
+}
+
+bool RocmBandwidthTest::GetResult(uint32_t trans_idx, uint32_t result_idx,
+                                  rbt_result_t& result) const {
+    const async_trans_t& trans = trans_list_[trans_idx];
+    if (result_idx >= trans.avg_bandwidth_.size()) {
+        return false;
+    }
+    memset(&result, 0, sizeof(result));
+    result.size = trans.size_list_[result_idx];
+    if (trans.avg_bandwidth_[result_idx] == VALIDATE_COPY_OP_FAILURE) {
+        return true;
+    }
+    result.valid = 1;
+    result.avg_time = trans.avg_time_[result_idx];
+    result.min_time = trans.min_time_[result_idx];
+    result.avg_bandwidth = trans.avg_bandwidth_[result_idx];
+    result.peak_bandwidth = trans.peak_bandwidth_[result_idx];
+    return true;
+}
+
+// Session of C API owns a test object, whose program name
+// is reported as launch command of its requests
+struct rbt_session_s {
+    RocmBandwidthTest* test_;
+    char* argv_[2];
+};
+
+static char rbt_prog_name[] = "librocm_bandwidth";
+
+rbt_status_t rbt_session_create(rbt_session_t* session) {
+    if (session == NULL) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    *session = NULL;
+
+    // Errors of test unwind to API instead of exiting process, only
+    // while the API is called, so a test object of the embedding
+    // program still exits as it does on its own
+    ExitUnwindScope unwind(true);
+    rbt_session_t handle = new rbt_session_s();
+    handle->argv_[0] = rbt_prog_name;
+    handle->argv_[1] = NULL;
+    handle->test_ = NULL;
+    try {
+        handle->test_ = new RocmBandwidthTest(1, handle->argv_);
+        handle->test_->OpenSession();
+    } catch (const test_exit_t&) {
+        delete handle->test_;
+        delete handle;
+        return RBT_STATUS_ERROR;
+    }
+    *session = handle;
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_session_destroy(rbt_session_t session) {
+    if (session == NULL) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    rbt_status_t status = RBT_STATUS_SUCCESS;
+    ExitUnwindScope unwind(session->test_->IsEmbedded());
+    try {
+        session->test_->Close();
+    } catch (const test_exit_t&) {
+        status = RBT_STATUS_ERROR;
+    }
+    delete session->test_;
+    delete session;
+    return status;
+}
+
+rbt_status_t rbt_get_device_count(rbt_session_t session, uint32_t* count) {
+    if ((session == NULL) || (count == NULL)) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    *count = session->test_->GetDeviceCount();
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_device_info(rbt_session_t session, uint32_t device_id,
+                                 rbt_device_info_t* info) {
+    if ((session == NULL) || (info == NULL) ||
+        (device_id >= session->test_->GetDeviceCount())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    session->test_->GetDeviceInfo(device_id, *info);
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_link_info(rbt_session_t session, uint32_t src_device_id,
+                               uint32_t dst_device_id, rbt_link_info_t* info) {
+    if ((session == NULL) || (info == NULL) ||
+        (src_device_id >= session->test_->GetDeviceCount()) ||
+        (dst_device_id >= session->test_->GetDeviceCount())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    ExitUnwindScope unwind(session->test_->IsEmbedded());
+    try {
+        session->test_->GetLinkInfo(src_device_id, dst_device_id, *info);
+    } catch (const test_exit_t&) {
+        return RBT_STATUS_ERROR;
+    }
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_build_request(rbt_session_t session, int argc, const char* const* argv) {
+    if ((session == NULL) || (argc < 0) || ((argc > 0) && (argv == NULL))) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    vector<std::string> args;
+    for (int idx = 0; idx < argc; idx++) {
+        if (argv[idx] == NULL) {
+            return RBT_STATUS_INVALID_ARGUMENT;
+        }
+        args.push_back(argv[idx]);
+    }
+    ExitUnwindScope unwind(session->test_->IsEmbedded());
+    try {
+        session->test_->SetUpRequest(args);
+    } catch (const test_exit_t&) {
+        return RBT_STATUS_INVALID_REQUEST;
+    }
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_transaction_count(rbt_session_t session, uint32_t* count) {
+    if ((session == NULL) || (count == NULL)) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    *count = session->test_->GetTransCount();
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_transaction_info(rbt_session_t session, uint32_t trans_idx,
+                                      rbt_transaction_info_t* info) {
+    if ((session == NULL) || (info == NULL) || (trans_idx >= session->test_->GetTransCount())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    session->test_->GetTransInfo(trans_idx, *info);
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_run(rbt_session_t session) {
+    if (session == NULL) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    ExitUnwindScope unwind(session->test_->IsEmbedded());
+    try {
+        session->test_->RunRequest();
+    } catch (const test_exit_t&) {
+        return RBT_STATUS_ERROR;
+    }
+    return session->test_->GetRunStatus();
+}
+
+rbt_status_t rbt_get_result(rbt_session_t session, uint32_t trans_idx, uint32_t result_idx,
+                            rbt_result_t* result) {
+    if ((session == NULL) || (result == NULL) || (trans_idx >= session->test_->GetTransCount())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    if (session->test_->GetResult(trans_idx, result_idx, *result) == false) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    return RBT_STATUS_SUCCESS;
+}
+
+const char* rbt_status_string(rbt_status_t status) {
+    switch (status) {
+        case RBT_STATUS_SUCCESS:
+            return "Success";
+        case RBT_STATUS_ERROR:
+            return "Roc runtime failed";
+        case RBT_STATUS_INVALID_ARGUMENT:
+            return "Argument is NULL or out of range";
+        case RBT_STATUS_INVALID_REQUEST:
+            return "Options of request are illegal or can't be combined";
+        case RBT_STATUS_VALIDATION_FAILED:
+            return "Copies failed validation";
+        case RBT_STATUS_REGRESSION:
+            return "Copies regressed against baseline";
+        case RBT_STATUS_LINK_DEGRADED:
+            return "Health check found a degraded link";
+        case RBT_STATUS_LINK_FAILED:
+            return "Health check found a failed link";
+        case RBT_STATUS_POOL_TOO_SMALL:
+            return "Pool can't hold buffers of copies";
+        default:
+            return "Unknown status";
+    }
+}
@@ -0,0 +1,379 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+
+// Significance level at which a drop of bandwidth is
+// considered real under Welch's t-test
+#define BASELINE_SIGNIFICANCE 0.01
+
+// First line of a baseline file, identifying its format
+#define BASELINE_FILE_HEADER "# rocm_bandwidth_test baseline v1"
+
+static std::string getBaselineSizeString(size_t size) {
+    std::stringstream size_str;
+    if ((size < 1024) || (size % 1024)) {
+        size_str << size << " Bytes";
+    } else if ((size < 1024 * 1024) || (size % (1024 * 1024))) {
+        size_str << size / 1024 << " KB";
+    } else {
+        size_str << size / (1024 * 1024) << " MB";
+    }
+    return size_str.str();
+}
+
+static std::string getBaselineReqType(uint32_t req_type) {
+    switch (req_type) {
+        case REQ_COPY_BIDIR:
+        case REQ_COPY_ALL_BIDIR:
+            return "bidir";
+        case REQ_CONCURRENT_COPY_BIDIR:
+            return "concurrent_bidir";
+        case REQ_CONCURRENT_COPY_UNIDIR:
+            return "concurrent_unidir";
+        default:
+            return "unidir";
+    }
+}
+
+static std::string getBaselineKey(const baseline_entry_t& entry) {
+    std::stringstream key;
+    key << entry.src_key_ << " " << entry.dst_key_ << " " << entry.req_type_ << " "
+        << entry.size_;
+    return key.str();
+}
+
+std::string RocmBandwidthTest::GetAgentKey(uint32_t dev_idx) const {
+    const agent_info_t& agent = agent_list_[dev_idx];
+    std::stringstream key;
+    if (agent.device_type_ == HSA_DEVICE_TYPE_GPU) {
+        // Devices without a unique id report GPU-XX
+        std::string uuid(agent.uuid_);
+        if ((uuid.empty()) || (uuid == "GPU-XX")) {
+            key << "BDF-" << agent.bdf_id_;
+        } else {
+            key << uuid;
+        }
+        return key.str();
+    }
+
+    uint32_t cpu_ordinal = 0;
+    for (uint32_t idx = 0; idx < dev_idx; idx++) {
+        if (agent_list_[idx].device_type_ == HSA_DEVICE_TYPE_CPU) {
+            cpu_ordinal++;
+        }
+    }
+    key << "CPU-" << cpu_ordinal;
+    return key.str();
+}
+
+uint32_t RocmBandwidthTest::GetPoolOrdinal(uint32_t pool_idx) const {
+    uint32_t ordinal = 0;
+    uint32_t dev_idx = pool_list_[pool_idx].agent_index_;
+    for (uint32_t idx = 0; idx < pool_idx; idx++) {
+        if (pool_list_[idx].agent_index_ == dev_idx) {
+            ordinal++;
+        }
+    }
+    return ordinal;
+}
+
+void RocmBandwidthTest::BuildBaselineEntry(const async_trans_t& trans, uint32_t size_idx,
+                                           baseline_entry_t& entry) const {
+    uint32_t src_idx = trans.copy.src_idx_;
+    uint32_t dst_idx = trans.copy.dst_idx_;
+    std::stringstream src_key;
+    std::stringstream dst_key;
+    src_key << GetAgentKey(pool_list_[src_idx].agent_index_) << ":" << GetPoolOrdinal(src_idx);
+    dst_key << GetAgentKey(pool_list_[dst_idx].agent_index_) << ":" << GetPoolOrdinal(dst_idx);
+
+    const stats_summary_t& stats = trans.stats_[size_idx];
+    entry.src_key_ = src_key.str();
+    entry.dst_key_ = dst_key.str();
+    entry.req_type_ = getBaselineReqType(trans.req_type_);
+    entry.size_ = trans.size_list_[size_idx];
+    entry.tolerance_ = regress_tolerance_;
+    entry.count_ = stats.count_;
+    entry.mean_time_ = stats.mean_;
+    entry.std_dev_ = stats.std_dev_;
+    entry.avg_bandwidth_ = trans.avg_bandwidth_[size_idx];
+    entry.peak_bandwidth_ = trans.peak_bandwidth_[size_idx];
+}
+
+void RocmBandwidthTest::SaveBaseline() const {
+    if (baseline_save_path_.empty()) {
+        return;
+    }
+
+    std::ofstream out(baseline_save_path_.c_str());
+    if (out.is_open() == false) {
+        std::cout << "Unable to create baseline file: " << baseline_save_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Tolerance of every copy can be edited after the file is saved
+    out << BASELINE_FILE_HEADER << std::endl;
+    out << "# src dst type size tolerance count mean_time(s) std_dev(s) avg_bw(GB/s) peak_bw(GB/s)"
+        << std::endl;
+    out.precision(9);
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
+            continue;
+        }
+        uint32_t size_len = trans.size_list_.size();
+        for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+            if (trans.min_time_[jdx] == VALIDATE_COPY_OP_FAILURE) {
+                continue;
+            }
+            baseline_entry_t entry;
+            BuildBaselineEntry(trans, jdx, entry);
+            out << entry.src_key_ << " " << entry.dst_key_ << " " << entry.req_type_ << " "
+                << entry.size_ << " " << entry.tolerance_ << " " << entry.count_ << " "
+                << entry.mean_time_ << " " << entry.std_dev_ << " " << entry.avg_bandwidth_
+                << " " << entry.peak_bandwidth_ << std::endl;
+        }
+    }
+
+    out.close();
+    if (out.fail()) {
+        std::cout << "Failed to write baseline file: " << baseline_save_path_ << std::endl;
+        exit_test(1);
+    }
+}
+
+std::string RocmBandwidthTest::GetBaselineKey(const async_trans_t& trans, size_t size) const {
+    uint32_t src_idx = trans.copy.src_idx_;
+    uint32_t dst_idx = trans.copy.dst_idx_;
+    std::stringstream src_key;
+    std::stringstream dst_key;
+    src_key << GetAgentKey(pool_list_[src_idx].agent_index_) << ":" << GetPoolOrdinal(src_idx);
+    dst_key << GetAgentKey(pool_list_[dst_idx].agent_index_) << ":" << GetPoolOrdinal(dst_idx);
+
+    baseline_entry_t entry;
+    entry.src_key_ = src_key.str();
+    entry.dst_key_ = dst_key.str();
+    entry.req_type_ = getBaselineReqType(trans.req_type_);
+    entry.size_ = size;
+    return getBaselineKey(entry);
+}
+
+void RocmBandwidthTest::LoadBaseline(std::map<std::string, baseline_entry_t>& base_map) const {
+    std::ifstream in(baseline_cmp_path_.c_str());
+    std::string line;
+    if ((in.is_open() == false) || (std::getline(in, line).fail()) ||
+        (line != BASELINE_FILE_HEADER)) {
+        std::cout << "Unable to read baseline file: " << baseline_cmp_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Read entries of baseline, skipping comments
+    while (std::getline(in, line)) {
+        if ((line.empty()) || (line[0] == '#')) {
+            continue;
+        }
+        baseline_entry_t entry;
+        std::istringstream fields(line);
+        fields >> entry.src_key_ >> entry.dst_key_ >> entry.req_type_ >> entry.size_ >>
+            entry.tolerance_ >> entry.count_ >> entry.mean_time_ >> entry.std_dev_ >>
+            entry.avg_bandwidth_ >> entry.peak_bandwidth_;
+        if (fields.fail()) {
+            std::cout << "Illegal entry in baseline file: " << line << std::endl;
+            exit_test(1);
+        }
+        base_map[getBaselineKey(entry)] = entry;
+    }
+}
+
+void RocmBandwidthTest::CompareBaseline() {
+    if (baseline_cmp_path_.empty()) {
+        return;
+    }
+    std::map<std::string, baseline_entry_t> base_map;
+    LoadBaseline(base_map);
+
+    // A copy regressed if its bandwidth dropped by more than the
+    // tolerance of its baseline and the drop is significant
+    baseline_diff_list_.clear();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
+            continue;
+        }
+        uint32_t size_len = trans.size_list_.size();
+        for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+            if (trans.min_time_[jdx] == VALIDATE_COPY_OP_FAILURE) {
+                continue;
+            }
+            baseline_entry_t curr;
+            BuildBaselineEntry(trans, jdx, curr);
+            std::map<std::string, baseline_entry_t>::iterator it;
+            it = base_map.find(getBaselineKey(curr));
+            if ((it == base_map.end()) || (curr.mean_time_ <= 0)) {
+                continue;
+            }
+
+            const baseline_entry_t& base = it->second;
+            baseline_diff_t diff;
+            diff.src_dev_idx_ = pool_list_[trans.copy.src_idx_].agent_index_;
+            diff.dst_dev_idx_ = pool_list_[trans.copy.dst_idx_].agent_index_;
+            diff.bidir_ = trans.copy.bidir_;
+            diff.size_ = curr.size_;
+            diff.base_bandwidth_ = base.avg_bandwidth_;
+            diff.curr_bandwidth_ = curr.avg_bandwidth_;
+            diff.change_ = (base.mean_time_ / curr.mean_time_) - 1;
+            diff.p_value_ = CalcWelchPValue(curr.mean_time_, curr.std_dev_ * curr.std_dev_,
+                                            curr.count_, base.mean_time_,
+                                            base.std_dev_ * base.std_dev_, base.count_);
+            diff.regressed_ =
+                ((diff.change_ < -base.tolerance_) && (diff.p_value_ < BASELINE_SIGNIFICANCE));
+            if (diff.regressed_) {
+                RaiseExitValue(REGRESSION_EXIT_VALUE);
+            }
+            baseline_diff_list_.push_back(diff);
+        }
+    }
+}
+
+void RocmBandwidthTest::DisplayBaselineDiff() const {
+    if (baseline_cmp_path_.empty()) {
+        return;
+    }
+
+    // One matrix is printed for every size compared, as copies
+    // of a run may cover different sizes
+    std::set<size_t> size_set;
+    uint32_t diff_cnt = baseline_diff_list_.size();
+    uint32_t regress_cnt = 0;
+    for (uint32_t idx = 0; idx < diff_cnt; idx++) {
+        size_set.insert(baseline_diff_list_[idx].size_);
+        regress_cnt += (baseline_diff_list_[idx].regressed_) ? 1 : 0;
+    }
+
+    std::cout.setf(ios::left);
+    std::set<size_t>::const_iterator size_it;
+    for (size_it = size_set.begin(); size_it != size_set.end(); size_it++) {
+        uint32_t format = 10;
+        uint32_t cell_cnt = agent_index_ * agent_index_;
+        vector<std::string> diff_matrix(cell_cnt, "N/A");
+        for (uint32_t idx = 0; idx < diff_cnt; idx++) {
+            const baseline_diff_t& diff = baseline_diff_list_[idx];
+            if (diff.size_ != *size_it) {
+                continue;
+            }
+            std::stringstream cell;
+            cell.precision(1);
+            cell << std::fixed << std::showpos << (diff.change_ * 100) << "%";
+            if (diff.regressed_) {
+                cell << "*";
+            }
+            diff_matrix[(diff.src_dev_idx_ * agent_index_) + diff.dst_dev_idx_] = cell.str();
+            if (diff.bidir_) {
+                diff_matrix[(diff.dst_dev_idx_ * agent_index_) + diff.src_dev_idx_] = cell.str();
+            }
+        }
+
+        std::cout << std::endl;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout << "Bandwidth change against baseline for " << getBaselineSizeString(*size_it)
+                  << " copies, * = regression" << std::endl;
+        std::cout << std::endl;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << "D/D";
+        format = 12;
+        for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+            std::cout.width(format);
+            std::cout << idx0;
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+        for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+            format = 10;
+            std::cout.width(format);
+            std::cout << "";
+            std::cout.width(format);
+            std::cout << idx0;
+            format = 12;
+            for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
+                std::cout.width(format);
+                std::cout << diff_matrix[(idx0 * agent_index_) + idx1];
+            }
+            std::cout << std::endl;
+            std::cout << std::endl;
+        }
+    }
+
+    // List every regressed copy
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    for (uint32_t idx = 0; idx < diff_cnt; idx++) {
+        const baseline_diff_t& diff = baseline_diff_list_[idx];
+        if (diff.regressed_ == false) {
+            continue;
+        }
+        std::cout.width(10);
+        std::cout << "";
+        std::cout << "Regression: Device " << diff.src_dev_idx_
+                  << ((diff.bidir_) ? " <-> " : " -> ") << "Device " << diff.dst_dev_idx_
+                  << ", " << diff.size_ << " Bytes, " << diff.base_bandwidth_ << " -> "
+                  << diff.curr_bandwidth_ << " GB/s, p = " << diff.p_value_ << std::endl;
+    }
+
+    std::cout.width(10);
+    std::cout << "";
+    std::cout << "Baseline comparison: " << ((regress_cnt == 0) ? "PASS" : "REGRESSED") << " ("
+              << regress_cnt << " of " << diff_cnt << " copies regressed)" << std::endl;
+    std::cout << std::endl;
+}
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iostream>
+
+// @brief: Return index of first pool whose demand exceeds its budget,
+// or -1 if all of them fit
+static int32_t getOverBudgetPool(const vector<size_t>& demand, const vector<size_t>& budget) {
+    uint32_t pool_cnt = demand.size();
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        if (demand[idx] > budget[idx]) {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+void RocmBandwidthTest::PlanPoolBudget() {
+    // Copies of a fan-out read one buffer of the pool they leave
+    share_src_bufs_ = (fan_mode_ == FAN_OUT);
+    if (size_list_.empty()) {
+        return;
+    }
+
+    uint32_t pool_cnt = pool_list_.size();
+    vector<size_t> budget(pool_cnt, 0);
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        budget[idx] = pool_list_[idx].allocable_size_ * pool_fraction_;
+    }
+    vector<size_t> demand;
+    GetPoolDemand(demand);
+    int32_t pool_idx = getOverBudgetPool(demand, budget);
+    if (pool_idx == -1) {
+        return;
+    }
+
+    // Concurrent copies only read their source buffers, so copies
+    // from the same pool can read one buffer
+    bool concurrent = (req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
+                      (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR);
+    if ((concurrent) && (share_src_bufs_ == false)) {
+        vector<size_t> shared_demand;
+        share_src_bufs_ = true;
+        GetPoolDemand(shared_demand);
+        if (shared_demand[pool_idx] < demand[pool_idx]) {
+            std::cout << "Concurrent copies share source buffers to fit memory budget of pool "
+                      << pool_idx << std::endl;
+            demand = shared_demand;
+            pool_idx = getOverBudgetPool(demand, budget);
+            if (pool_idx == -1) {
+                return;
+            }
+        } else {
+            share_src_bufs_ = false;
+        }
+    }
+
+    // Demand of a pool is a multiple of the largest size, which
+    // is capped to the largest one every pool can hold
+    size_t max_size = size_list_.back();
+    size_t cap_size = max_size;
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        size_t factor = demand[idx] / max_size;
+        if ((factor != 0) && ((budget[idx] / factor) < cap_size)) {
+            cap_size = budget[idx] / factor;
+            pool_idx = idx;
+        }
+    }
+    size_t unit = (cap_size >= (1024 * 1024)) ? (1024 * 1024) : 4096;
+    cap_size -= (cap_size % unit);
+    if (cap_size == 0) {
+        // Dry run reports pools that can't hold buffers of copies
+        if (dry_run_) {
+            return;
+        }
+        std::cout << "Memory budget of pool " << pool_idx << " can't hold buffers of copies"
+                  << std::endl;
+        std::cout << "Value of ROCM_BW_POOL_FRACTION is " << pool_fraction_ << std::endl;
+        exit_test(1);
+    }
+
+    // Sizes above the cap are replaced by the cap
+    while ((size_list_.empty() == false) && (size_list_.back() > cap_size)) {
+        size_list_.pop_back();
+    }
+    if ((size_list_.empty()) || (size_list_.back() < cap_size)) {
+        size_list_.push_back(cap_size);
+    }
+    std::cout << "Largest size of " << (max_size / (1024 * 1024.0))
+              << " MB exceeds memory budget of pool " << pool_idx << ", capped to "
+              << (cap_size / (1024 * 1024.0)) << " MB" << std::endl;
+}
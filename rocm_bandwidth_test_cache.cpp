@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Format of cache file, bumped whenever its layout or the way
+// matrices are computed changes so stale caches are discarded
+#define TOPOLOGY_CACHE_VERSION 1
+
+// @brief: Fold bytes of a value into a 64-bit FNV-1a hash
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t idx = 0; idx < size; idx++) {
+        hash ^= bytes[idx];
+        hash *= 0x100000001B3ULL;
+    }
+}
+
+static void hashString(uint64_t& hash, const std::string& value) {
+    // Include terminator so adjacent strings can't run together
+    hashBytes(hash, value.c_str(), value.size() + 1);
+}
+
+uint64_t RocmBandwidthTest::GetTopologyFingerprint() const {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    uint32_t version = TOPOLOGY_CACHE_VERSION;
+    hashBytes(hash, &version, sizeof(version));
+
+    // Versions of runtime and kernel driver, which compute access and links
+    uint16_t major = 0;
+    uint16_t minor = 0;
+    transport_->GetSystemInfo(HSA_SYSTEM_INFO_VERSION_MAJOR, &major);
+    transport_->GetSystemInfo(HSA_SYSTEM_INFO_VERSION_MINOR, &minor);
+    hashBytes(hash, &major, sizeof(major));
+    hashBytes(hash, &minor, sizeof(minor));
+    std::string driver;
+    std::ifstream in((sysfs_root_ + "/module/amdgpu/version").c_str());
+    if (in.is_open()) {
+        std::getline(in, driver);
+    }
+    hashString(hash, driver);
+
+    // Env keys that filter the pools being discovered
+    bool skip_cpu_fine = (skip_cpu_fine_grain_ != NULL);
+    bool skip_gpu_coarse = (skip_gpu_coarse_grain_ != NULL);
+    hashBytes(hash, &skip_cpu_fine, sizeof(skip_cpu_fine));
+    hashBytes(hash, &skip_gpu_coarse, sizeof(skip_gpu_coarse));
+
+    // Identity of every agent and the pools discovered on it
+    hashBytes(hash, &agent_index_, sizeof(agent_index_));
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        const agent_pool_info_t& node = agent_pool_list_[idx];
+        uint32_t dev_type = node.agent.device_type_;
+        hashBytes(hash, &dev_type, sizeof(dev_type));
+        hashString(hash, node.agent.name_);
+        if (node.agent.device_type_ == HSA_DEVICE_TYPE_GPU) {
+            hashString(hash, node.agent.uuid_);
+            hashString(hash, node.agent.bdf_id_);
+            hashBytes(hash, &node.agent.domain_, sizeof(node.agent.domain_));
+        }
+        uint32_t pool_count = node.pool_list.size();
+        hashBytes(hash, &pool_count, sizeof(pool_count));
+        for (uint32_t jdx = 0; jdx < pool_count; jdx++) {
+            const pool_info_t& pool = node.pool_list[jdx];
+            uint64_t size = pool.allocable_size_;
+            hashBytes(hash, &size, sizeof(size));
+            hashBytes(hash, &pool.is_fine_grained_, sizeof(pool.is_fine_grained_));
+            hashBytes(hash, &pool.is_kernarg_, sizeof(pool.is_kernarg_));
+        }
+    }
+    return hash;
+}
+
+bool RocmBandwidthTest::LoadTopologyCache(uint64_t fingerprint) {
+    std::ifstream in(bw_topology_cache_);
+    if (in.is_open() == false) {
+        return false;
+    }
+
+    // Header carries the fingerprint of topology it was built from
+    std::string magic;
+    uint64_t cached = 0;
+    uint32_t count = 0;
+    in >> magic >> std::hex >> cached >> std::dec >> count;
+    if ((in.fail()) || (magic != "rocm_bandwidth_test_topology") || (cached != fingerprint) ||
+        (count != agent_index_)) {
+        return false;
+    }
+
+    // Matrices are listed in a fixed order, each of agents squared values
+    uint32_t cell_cnt = agent_index_ * agent_index_;
+    vector<uint32_t> values(cell_cnt * 5);
+    for (uint32_t idx = 0; idx < values.size(); idx++) {
+        in >> values[idx];
+    }
+    if (in.fail()) {
+        return false;
+    }
+
+    uint32_t* matrices[] = {access_matrix_, direct_access_matrix_, link_type_matrix_,
+                            link_hops_matrix_, link_weight_matrix_};
+    for (uint32_t idx = 0; idx < 5; idx++) {
+        std::copy(values.begin() + (idx * cell_cnt), values.begin() + ((idx + 1) * cell_cnt),
+                  matrices[idx]);
+    }
+    std::fill(access_known_, access_known_ + cell_cnt, 1);
+    std::fill(link_known_, link_known_ + cell_cnt, 1);
+    return true;
+}
+
+void RocmBandwidthTest::SaveTopologyCache(uint64_t fingerprint) const {
+    std::stringstream out;
+    out << "rocm_bandwidth_test_topology " << std::hex << fingerprint << std::dec << " "
+        << agent_index_ << "\n";
+    uint32_t cell_cnt = agent_index_ * agent_index_;
+    const uint32_t* matrices[] = {access_matrix_, direct_access_matrix_, link_type_matrix_,
+                                  link_hops_matrix_, link_weight_matrix_};
+    for (uint32_t idx = 0; idx < 5; idx++) {
+        for (uint32_t jdx = 0; jdx < cell_cnt; jdx++) {
+            out << matrices[idx][jdx] << (((jdx + 1) % agent_index_) ? " " : "\n");
+        }
+    }
+
+    // Rename a temporary file into place so that concurrent runs
+    // never read a partially written cache. Failure is not fatal
+    std::string path(bw_topology_cache_);
+    std::stringstream tmp_path;
+    tmp_path << path << "." << getpid() << ".tmp";
+    std::ofstream file(tmp_path.str().c_str());
+    file << out.str();
+    file.close();
+    if ((file.fail()) || (rename(tmp_path.str().c_str(), path.c_str()) != 0)) {
+        std::cout << "Unable to write topology cache: " << path << std::endl;
+        unlink(tmp_path.str().c_str());
+    }
+}
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+std::ostream& RocmBandwidthTest::DaemonLog() {
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &local);
+    std::ostream& out = (daemon_log_.is_open()) ? daemon_log_ : std::cout;
+    out << stamp << " ";
+    return out;
+}
+
+std::string RocmBandwidthTest::GetDaemonLinkString(const async_trans_t& trans,
+                                                   size_t size) const {
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    std::stringstream link;
+    link << "Device " << src_dev_idx << ((trans.copy.bidir_) ? " <-> " : " -> ") << "Device "
+         << dst_dev_idx << ", " << size << " Bytes";
+    return link.str();
+}
+
+void RocmBandwidthTest::RunDaemon() {
+    DaemonLog() << "Daemon started with duty cycle " << (duty_cycle_ * 100) << "% and window of "
+                << daemon_window_ << " runs" << std::endl;
+
+    uint64_t run_cnt = 0;
+    while (true) {
+        std::chrono::time_point<std::chrono::steady_clock> start;
+        start = std::chrono::steady_clock::now();
+        RunRequests();
+        std::chrono::duration<double> busy = std::chrono::steady_clock::now() - start;
+
+        // Report drops, trends and regressions against baseline
+        UpdateDaemonWindows();
+        CompareBaseline();
+        uint32_t diff_cnt = baseline_diff_list_.size();
+        for (uint32_t idx = 0; idx < diff_cnt; idx++) {
+            const baseline_diff_t& diff = baseline_diff_list_[idx];
+            if (diff.regressed_) {
+                DaemonLog() << "REGRESSION Device " << diff.src_dev_idx_
+                            << ((diff.bidir_) ? " <-> " : " -> ") << "Device "
+                            << diff.dst_dev_idx_ << ", " << diff.size_ << " Bytes: "
+                            << diff.curr_bandwidth_ << " GB/s against baseline of "
+                            << diff.base_bandwidth_ << " GB/s" << std::endl;
+            }
+        }
+        WritePrometheusReport();
+        run_cnt++;
+        if ((run_cnt % daemon_window_) == 0) {
+            LogDaemonSummary();
+        }
+
+        // Stay idle long enough to keep the time spent running
+        // requests within duty cycle, but no less than export interval
+        double idle = busy.count() * (1 - duty_cycle_) / duty_cycle_;
+        idle = std::max(idle, (double)export_interval_);
+        std::this_thread::sleep_for(std::chrono::duration<double>(idle));
+        ResetCopyResults();
+    }
+}
+
+void RocmBandwidthTest::UpdateDaemonWindows() {
+    uint32_t trans_size = trans_list_.size();
+    daemon_windows_.resize(trans_size);
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
+            continue;
+        }
+
+        // Windows are keyed by size, so a window only holds
+        // bandwidths of copies of one size
+        uint32_t size_len = trans.size_list_.size();
+        std::map<size_t, link_window_t>& window_map = daemon_windows_[idx];
+        for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+            link_window_t& window = window_map[trans.size_list_[jdx]];
+            if (window.samples_.empty()) {
+                window.samples_.resize(daemon_window_);
+            }
+
+            double bandwidth = trans.avg_bandwidth_[jdx];
+            if (bandwidth == VALIDATE_COPY_OP_FAILURE) {
+                continue;
+            }
+
+            // Compare with mean of the window before adding to it
+            std::string link = GetDaemonLinkString(trans, trans.size_list_[jdx]);
+            if (window.count_ >= 2) {
+                double mean = 0;
+                for (uint32_t kdx = 0; kdx < window.count_; kdx++) {
+                    mean += window.samples_[kdx];
+                }
+                mean /= window.count_;
+                if (bandwidth < (mean * (1 - regress_tolerance_))) {
+                    DaemonLog() << "DROP " << link << ": " << bandwidth
+                                << " GB/s against window mean of " << mean << " GB/s"
+                                << std::endl;
+                }
+            }
+            window.samples_[window.head_] = bandwidth;
+            window.head_ = (window.head_ + 1) % daemon_window_;
+            window.count_ = std::min(window.count_ + 1, daemon_window_);
+            if (window.count_ < daemon_window_) {
+                continue;
+            }
+
+            // Once full the oldest sample is at head of the ring.
+            // Trend compares mean of newer half with older half
+            uint32_t half = daemon_window_ / 2;
+            double older = 0;
+            double newer = 0;
+            for (uint32_t kdx = 0; kdx < half; kdx++) {
+                older += window.samples_[(window.head_ + kdx) % daemon_window_];
+                newer += window.samples_[(window.head_ + daemon_window_ - 1 - kdx) %
+                                         daemon_window_];
+            }
+            double change = (newer / older) - 1;
+            if ((change < -regress_tolerance_) && (window.trending_ == false)) {
+                window.trending_ = true;
+                DaemonLog() << "TREND " << link << ": bandwidth down by " << (-change * 100)
+                            << "% over last " << daemon_window_ << " runs" << std::endl;
+            } else if ((change > -regress_tolerance_ / 2) && (window.trending_)) {
+                window.trending_ = false;
+                DaemonLog() << "RECOVERED " << link << ": bandwidth trend is flat" << std::endl;
+            }
+        }
+    }
+}
+
+void RocmBandwidthTest::LogDaemonSummary() {
+    uint32_t trans_size = daemon_windows_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        const std::map<size_t, link_window_t>& window_map = daemon_windows_[idx];
+        std::map<size_t, link_window_t>::const_iterator it;
+        for (it = window_map.begin(); it != window_map.end(); it++) {
+            const link_window_t& window = it->second;
+            if (window.count_ == 0) {
+                continue;
+            }
+            double mean = 0;
+            double min_bw = window.samples_[0];
+            double max_bw = window.samples_[0];
+            for (uint32_t kdx = 0; kdx < window.count_; kdx++) {
+                mean += window.samples_[kdx];
+                min_bw = std::min(min_bw, window.samples_[kdx]);
+                max_bw = std::max(max_bw, window.samples_[kdx]);
+            }
+            mean /= window.count_;
+            DaemonLog() << "SUMMARY " << GetDaemonLinkString(trans, it->first)
+                        << ": mean " << mean << " min " << min_bw << " max " << max_bw
+                        << " GB/s over " << window.count_ << " runs" << std::endl;
+        }
+    }
+}
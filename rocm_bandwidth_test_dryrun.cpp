@@ -0,0 +1,349 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+static bool isCopyRequest(uint32_t req_type) {
+    return ((req_type == REQ_COPY_BIDIR) || (req_type == REQ_COPY_UNIDIR) ||
+            (req_type == REQ_COPY_ALL_BIDIR) || (req_type == REQ_COPY_ALL_UNIDIR) ||
+            (req_type == REQ_CONCURRENT_COPY_BIDIR) || (req_type == REQ_CONCURRENT_COPY_UNIDIR));
+}
+
+void RocmBandwidthTest::GetPoolDemand(vector<size_t>& demand) const {
+    uint32_t pool_cnt = pool_list_.size();
+    demand.assign(pool_cnt, 0);
+    if (size_list_.empty()) {
+        return;
+    }
+
+    // Every copy allocates buffers of the largest size in its pools,
+    // for both directions if it is bidirectional
+    size_t max_size = size_list_.back();
+    bool concurrent = (req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
+                      (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR);
+    vector<bool> init_list(agent_index_, false);
+    vector<bool> validate_list(agent_index_, false);
+    vector<bool> shared(pool_cnt, false);
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if (isCopyRequest(trans.req_type_) == false) {
+            continue;
+        }
+        uint32_t src_idx = trans.copy.src_idx_;
+        uint32_t dst_idx = trans.copy.dst_idx_;
+        size_t need = (trans.copy.bidir_) ? (max_size * 2) : max_size;
+        if (concurrent) {
+            demand[dst_idx] += max_size;
+            if ((share_src_bufs_ == false) || (shared[src_idx] == false)) {
+                demand[src_idx] += max_size;
+                shared[src_idx] = true;
+            }
+            if (trans.copy.bidir_) {
+                demand[src_idx] += max_size;
+                if ((share_src_bufs_ == false) || (shared[dst_idx] == false)) {
+                    demand[dst_idx] += max_size;
+                    shared[dst_idx] = true;
+                }
+            }
+        } else if (src_idx == dst_idx) {
+            demand[src_idx] = std::max(demand[src_idx], need * 2);
+        } else {
+            demand[src_idx] = std::max(demand[src_idx], need);
+            demand[dst_idx] = std::max(demand[dst_idx], need);
+        }
+
+        // Source buffers are initialized from host buffers staged near
+        // the source device, and destination validated near its device
+        uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
+        init_list[src_dev_idx] = true;
+        if (trans.copy.bidir_) {
+            init_list[dst_dev_idx] = true;
+        }
+        if (validate_) {
+            validate_list[dst_dev_idx] = true;
+        }
+    }
+
+    // Host buffers are allocated once per Cpu agent that stages them
+    vector<uint32_t> staged(agent_index_, 0);
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        int32_t cpu_dev_idx = GetStagingAgent(idx);
+        if (cpu_dev_idx == -1) {
+            continue;
+        }
+        staged[cpu_dev_idx] |= (init_list[idx]) ? 0x01 : 0x00;
+        staged[cpu_dev_idx] |= (validate_list[idx]) ? 0x02 : 0x00;
+    }
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        if (staged[idx] == 0) {
+            continue;
+        }
+        for (uint32_t jdx = 0; jdx < pool_cnt; jdx++) {
+            if (pool_list_[jdx].pool_.handle != staging_list_[idx].pool_.handle) {
+                continue;
+            }
+            demand[jdx] += (staged[idx] & 0x01) ? max_size : 0;
+            demand[jdx] += (staged[idx] & 0x02) ? max_size : 0;
+        }
+    }
+}
+
+double RocmBandwidthTest::GetEstimatedBandwidth(
+    const async_trans_t& trans, size_t size,
+    const std::map<std::string, baseline_entry_t>& base_map, bool& from_baseline) const {
+    // Baseline of a previous run measured the copy itself
+    from_baseline = false;
+    std::map<std::string, baseline_entry_t>::const_iterator it;
+    it = base_map.find(GetBaselineKey(trans, size));
+    if ((it != base_map.end()) && (it->second.avg_bandwidth_ > 0)) {
+        from_baseline = true;
+        return it->second.avg_bandwidth_;
+    }
+
+    // Priors of health check are per direction of a link between
+    // two devices, and there is none for copies within a device
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    if (src_dev_idx == dst_dev_idx) {
+        return 0;
+    }
+    double bandwidth = GetExpectedBandwidth(src_dev_idx, dst_dev_idx);
+    return (trans.copy.bidir_) ? (bandwidth * 2) : bandwidth;
+}
+
+void RocmBandwidthTest::DisplayDryRun() {
+    PrintVersion();
+
+    // Runtime is estimated from baseline of user if one is given,
+    // and from link priors of health check otherwise
+    std::map<std::string, baseline_entry_t> base_map;
+    if (baseline_cmp_path_.empty() == false) {
+        LoadBaseline(base_map);
+    }
+    if (health_table_.empty()) {
+        LoadHealthTable();
+    }
+
+    uint32_t iterations = GetIterationNum();
+    bool concurrent = (req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
+                      (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR);
+    uint32_t size_len = size_list_.size();
+    uint32_t trans_size = trans_list_.size();
+    vector<double> group_time(size_len, 0);
+    double total_bytes = 0;
+    double total_time = 0;
+    uint32_t baseline_cnt = 0;
+    uint32_t prior_cnt = 0;
+    uint32_t unknown_cnt = 0;
+
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Dry run, copies are planned but not run" << std::endl;
+    std::cout << std::endl;
+    const char* titles[] = {"Id", "Src", "Dst", "Type", "Data(MB)", "Time(ms)", "Estimate"};
+    std::cout.width(format);
+    std::cout << "";
+    for (uint32_t idx = 0; idx < 7; idx++) {
+        std::cout.width((idx < 4) ? 10 : 12);
+        std::cout << titles[idx];
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if (isCopyRequest(trans.req_type_) == false) {
+            continue;
+        }
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+
+        // Data moved is counted the way bandwidth of copy is computed.
+        // Adaptive sweeps pick their sizes as they run, so neither data
+        // nor time of their copies is known before
+        double trans_bytes = 0;
+        double trans_time = 0;
+        uint32_t estimate = 0;
+        for (uint32_t jdx = 0; (adaptive_ == false) && (jdx < size_len); jdx++) {
+            size_t data_size = size_list_[jdx];
+            data_size += (trans.copy.bidir_) ? data_size : 0;
+            data_size += (src_dev_idx == dst_dev_idx) ? data_size : 0;
+            double bytes = (double)data_size * iterations;
+            trans_bytes += bytes;
+
+            bool from_baseline = false;
+            double bandwidth = GetEstimatedBandwidth(trans, size_list_[jdx], base_map,
+                                                     from_baseline);
+            if (bandwidth <= 0) {
+                continue;
+            }
+            double time = bytes / (bandwidth * 1000 * 1000 * 1000);
+            trans_time += time;
+            group_time[jdx] = std::max(group_time[jdx], time);
+            estimate |= (from_baseline) ? 0x01 : 0x02;
+        }
+        total_bytes += trans_bytes;
+        if (concurrent == false) {
+            total_time += trans_time;
+        }
+
+        const char* source = (adaptive_) ? "sweep" : "N/A";
+        if (estimate == 0x01) {
+            source = "baseline";
+            baseline_cnt++;
+        } else if (estimate != 0) {
+            source = (estimate == 0x02) ? "prior" : "mixed";
+            prior_cnt++;
+        } else {
+            unknown_cnt++;
+        }
+
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(10);
+        std::cout << idx;
+        std::cout.width(10);
+        std::cout << src_dev_idx;
+        std::cout.width(10);
+        std::cout << dst_dev_idx;
+        std::cout.width(10);
+        std::cout << ((trans.copy.bidir_) ? "bidir" : "unidir");
+        std::cout.width(12);
+        if (adaptive_) {
+            std::cout << "N/A";
+        } else {
+            std::cout << (trans_bytes / (1024 * 1024));
+        }
+        std::cout.width(12);
+        if (estimate == 0) {
+            std::cout << "N/A";
+        } else {
+            std::cout << (trans_time * 1000);
+        }
+        std::cout.width(12);
+        std::cout << source;
+        std::cout << std::endl;
+    }
+
+    // Concurrent copies of a size run together and take as long
+    // as the slowest of them
+    if (concurrent) {
+        for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+            total_time += group_time[jdx];
+        }
+    }
+
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    if (adaptive_) {
+        std::cout << "Sizes per copy are picked by adaptive sweep as it runs, so data and"
+                  << " runtime are not estimated" << std::endl;
+    } else {
+        // Data is counted in powers of 1024, as sizes of copies are
+        std::cout << "Sizes per copy: " << size_len << ", iterations per size: " << iterations
+                  << std::endl;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout << "Total data to move: " << (total_bytes / (1024 * 1024 * 1024)) << " GB"
+                  << std::endl;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout << "Estimated runtime: " << total_time << " s (" << baseline_cnt
+                  << " copies from baseline, " << prior_cnt << " from link priors, "
+                  << unknown_cnt << " not estimated)" << std::endl;
+    }
+
+    // Memory every pool needs, checked against what it can allocate
+    vector<size_t> demand;
+    GetPoolDemand(demand);
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Memory needed by pools" << std::endl;
+    std::cout << std::endl;
+    const char* pool_titles[] = {"Pool", "Device", "Needed(MB)", "Allocable(MB)", "Status"};
+    std::cout.width(format);
+    std::cout << "";
+    for (uint32_t idx = 0; idx < 5; idx++) {
+        std::cout.width((idx < 2) ? 10 : 16);
+        std::cout << pool_titles[idx];
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+    uint32_t pool_cnt = pool_list_.size();
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        if (demand[idx] == 0) {
+            continue;
+        }
+        bool fits = (demand[idx] <= pool_list_[idx].allocable_size_);
+        if (fits == false) {
+            RaiseExitValue(DRY_RUN_EXIT_VALUE);
+        }
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(10);
+        std::cout << idx;
+        std::cout.width(10);
+        std::cout << pool_list_[idx].agent_index_;
+        std::cout.width(16);
+        std::cout << ((double)demand[idx] / (1024 * 1024));
+        std::cout.width(16);
+        std::cout << ((double)pool_list_[idx].allocable_size_ / (1024 * 1024));
+        std::cout.width(16);
+        std::cout << ((fits) ? "OK" : "EXCEEDED");
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Escape a string for use within a double quoted DOT identifier
+static std::string getDotString(const char* value) {
+    std::string str;
+    for (const char* ptr = value; *ptr != '\0'; ptr++) {
+        if ((*ptr == '"') || (*ptr == '\\')) {
+            str += '\\';
+        }
+        str += *ptr;
+    }
+    return str;
+}
+
+// Escape a string for use as XML character data or attribute value
+static std::string getXmlString(const char* value) {
+    std::string str;
+    for (const char* ptr = value; *ptr != '\0'; ptr++) {
+        switch (*ptr) {
+            case '&':
+                str += "&amp;";
+                break;
+            case '<':
+                str += "&lt;";
+                break;
+            case '>':
+                str += "&gt;";
+                break;
+            case '"':
+                str += "&quot;";
+                break;
+            default:
+                str += *ptr;
+                break;
+        }
+    }
+    return str;
+}
+
+static bool isGraphMLFile(const std::string& path) {
+    const std::string ext(".graphml");
+    if (path.size() < ext.size()) {
+        return false;
+    }
+    return (path.compare(path.size() - ext.size(), ext.size(), ext) == 0);
+}
+
+const char* RocmBandwidthTest::GetGraphLinkType(uint32_t src_dev_idx,
+                                                uint32_t dst_dev_idx) const {
+    uint32_t link_type = GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx);
+    if (link_type == LINK_TYPE_XGMI) {
+        return "xGMI";
+    } else if (link_type == LINK_TYPE_PCIE) {
+        return "PCIe";
+    }
+    return "other";
+}
+
+void RocmBandwidthTest::PopulateGraphBandwidth(vector<double>& bw_matrix) const {
+    uint32_t agent_cnt = agent_list_.size();
+    bw_matrix.assign(agent_cnt * agent_cnt, 0);
+
+    // Edges are annotated with peak bandwidth of unidirectional copies
+    // only, as bidirectional ones report the sum of both directions
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ != REQ_COPY_UNIDIR) && (trans.req_type_ != REQ_COPY_ALL_UNIDIR)) {
+            continue;
+        }
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        double& bandwidth = bw_matrix[(src_dev_idx * agent_cnt) + dst_dev_idx];
+        uint32_t size_len = trans.peak_bandwidth_.size();
+        for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+            if (trans.min_time_[jdx] == VALIDATE_COPY_OP_FAILURE) {
+                continue;
+            }
+            if (trans.peak_bandwidth_[jdx] > bandwidth) {
+                bandwidth = trans.peak_bandwidth_[jdx];
+            }
+        }
+    }
+}
+
+void RocmBandwidthTest::WriteGraphDot(std::ostream& out, const vector<double>& bw_matrix) const {
+    uint32_t agent_cnt = agent_list_.size();
+    out << "digraph rocm_topology {\n";
+    out << "  node [shape=box];\n";
+    for (uint32_t idx = 0; idx < agent_cnt; idx++) {
+        const agent_info_t& agent = agent_list_[idx];
+        bool gpu = (agent.device_type_ == HSA_DEVICE_TYPE_GPU);
+        out << "  \"" << idx << "\" [label=\"" << idx << ": " << getDotString(agent.name_);
+        if (gpu) {
+            out << "\\n" << getDotString(agent.bdf_id_);
+        }
+        out << "\", type=\"" << ((gpu) ? "GPU" : "CPU") << "\"";
+        if (gpu) {
+            out << ", uuid=\"" << getDotString(agent.uuid_) << "\"";
+            out << ", bdf=\"" << getDotString(agent.bdf_id_) << "\"";
+        }
+        out << "];\n";
+    }
+
+    // Links without a measured copy carry no bandwidth attribute
+    for (uint32_t src = 0; src < agent_cnt; src++) {
+        for (uint32_t dst = 0; dst < agent_cnt; dst++) {
+            if ((src == dst) || (GetLinkProp(LINK_PROP_TYPE, src, dst) == LINK_TYPE_NO_PATH)) {
+                continue;
+            }
+            const char* link_str = GetGraphLinkType(src, dst);
+            uint32_t hops = GetLinkProp(LINK_PROP_HOPS, src, dst);
+            uint32_t weight = GetLinkProp(LINK_PROP_WEIGHT, src, dst);
+            double bandwidth = bw_matrix[(src * agent_cnt) + dst];
+            out << "  \"" << src << "\" -> \"" << dst << "\" [label=\"" << link_str;
+            if (bandwidth > 0) {
+                out << "\\n" << bandwidth << " GB/s";
+            }
+            out << "\", type=\"" << link_str << "\"";
+            if (hops != 0xFFFFFFFF) {
+                out << ", hops=" << hops;
+            }
+            if (weight != 0xFFFFFFFF) {
+                out << ", weight=" << weight;
+            }
+            if (bandwidth > 0) {
+                out << ", bandwidth=" << bandwidth;
+            }
+            out << "];\n";
+        }
+    }
+    out << "}\n";
+}
+
+void RocmBandwidthTest::WriteGraphML(std::ostream& out, const vector<double>& bw_matrix) const {
+    uint32_t agent_cnt = agent_list_.size();
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n";
+    out << "  <key id=\"name\" for=\"node\" attr.name=\"name\" attr.type=\"string\"/>\n";
+    out << "  <key id=\"type\" for=\"node\" attr.name=\"type\" attr.type=\"string\"/>\n";
+    out << "  <key id=\"uuid\" for=\"node\" attr.name=\"uuid\" attr.type=\"string\"/>\n";
+    out << "  <key id=\"bdf\" for=\"node\" attr.name=\"bdf\" attr.type=\"string\"/>\n";
+    out << "  <key id=\"link\" for=\"edge\" attr.name=\"type\" attr.type=\"string\"/>\n";
+    out << "  <key id=\"hops\" for=\"edge\" attr.name=\"hops\" attr.type=\"int\"/>\n";
+    out << "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"int\"/>\n";
+    out << "  <key id=\"bandwidth\" for=\"edge\" attr.name=\"bandwidth_gbps\" "
+        << "attr.type=\"double\"/>\n";
+    out << "  <graph id=\"rocm_topology\" edgedefault=\"directed\">\n";
+    for (uint32_t idx = 0; idx < agent_cnt; idx++) {
+        const agent_info_t& agent = agent_list_[idx];
+        bool gpu = (agent.device_type_ == HSA_DEVICE_TYPE_GPU);
+        out << "    <node id=\"n" << idx << "\">\n";
+        out << "      <data key=\"name\">" << getXmlString(agent.name_) << "</data>\n";
+        out << "      <data key=\"type\">" << ((gpu) ? "GPU" : "CPU") << "</data>\n";
+        if (gpu) {
+            out << "      <data key=\"uuid\">" << getXmlString(agent.uuid_) << "</data>\n";
+            out << "      <data key=\"bdf\">" << getXmlString(agent.bdf_id_) << "</data>\n";
+        }
+        out << "    </node>\n";
+    }
+
+    for (uint32_t src = 0; src < agent_cnt; src++) {
+        for (uint32_t dst = 0; dst < agent_cnt; dst++) {
+            if ((src == dst) || (GetLinkProp(LINK_PROP_TYPE, src, dst) == LINK_TYPE_NO_PATH)) {
+                continue;
+            }
+            uint32_t hops = GetLinkProp(LINK_PROP_HOPS, src, dst);
+            uint32_t weight = GetLinkProp(LINK_PROP_WEIGHT, src, dst);
+            double bandwidth = bw_matrix[(src * agent_cnt) + dst];
+            out << "    <edge source=\"n" << src << "\" target=\"n" << dst << "\">\n";
+            out << "      <data key=\"link\">" << GetGraphLinkType(src, dst) << "</data>\n";
+            if (hops != 0xFFFFFFFF) {
+                out << "      <data key=\"hops\">" << hops << "</data>\n";
+            }
+            if (weight != 0xFFFFFFFF) {
+                out << "      <data key=\"weight\">" << weight << "</data>\n";
+            }
+            if (bandwidth > 0) {
+                out << "      <data key=\"bandwidth\">" << bandwidth << "</data>\n";
+            }
+            out << "    </edge>\n";
+        }
+    }
+    out << "  </graph>\n";
+    out << "</graphml>\n";
+}
+
+void RocmBandwidthTest::WriteGraphReport() const {
+    if (graph_file_path_.empty()) {
+        return;
+    }
+
+    std::ofstream out(graph_file_path_.c_str());
+    if (out.is_open() == false) {
+        std::cout << "Unable to create graph file: " << graph_file_path_ << std::endl;
+        exit_test(1);
+    }
+
+    vector<double> bw_matrix;
+    PopulateGraphBandwidth(bw_matrix);
+    out.precision(6);
+    if (isGraphMLFile(graph_file_path_)) {
+        WriteGraphML(out, bw_matrix);
+    } else {
+        WriteGraphDot(out, bw_matrix);
+    }
+
+    out.close();
+    if (out.fail()) {
+        std::cout << "Failed to write graph file: " << graph_file_path_ << std::endl;
+        exit_test(1);
+    }
+}
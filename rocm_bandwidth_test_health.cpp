@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Grades are bound to references, so they need a definition
+const uint32_t RocmBandwidthTest::HEALTH_NONE;
+const uint32_t RocmBandwidthTest::HEALTH_PASS;
+const uint32_t RocmBandwidthTest::HEALTH_DEGRADED;
+const uint32_t RocmBandwidthTest::HEALTH_FAIL;
+
+void RocmBandwidthTest::LoadHealthTable() {
+    health_table_.clear();
+    // Built-in table holds conservative floors in GB/s that a PCIe Gen3
+    // x16 link and a single xGMI link clear, so a healthy system never
+    // fails. Supply a table to check tighter bounds
+    if (bw_health_table_ == NULL) {
+        health_expect_t entry;
+        entry.hops_ = 0xFFFFFFFF;
+        entry.name_ = "*";
+        entry.link_type_ = LINK_TYPE_PCIE;
+        entry.bandwidth_ = 10.0;
+        health_table_.push_back(entry);
+        entry.link_type_ = LINK_TYPE_XGMI;
+        entry.bandwidth_ = 30.0;
+        health_table_.push_back(entry);
+        return;
+    }
+
+    // Each line is: <PCIe|xGMI> <hops|*> <GB/s> <device name|*>
+    // Device name is rest of line as product names carry spaces
+    std::ifstream in(bw_health_table_);
+    if (in.is_open() == false) {
+        std::cout << "Unable to read health table: " << bw_health_table_ << std::endl;
+        exit_test(1);
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if ((line.empty()) || (line[0] == '#')) {
+            continue;
+        }
+        std::string type;
+        std::string hops;
+        health_expect_t entry;
+        entry.bandwidth_ = 0;
+        std::istringstream fields(line);
+        fields >> type >> hops >> entry.bandwidth_ >> std::ws;
+        std::getline(fields, entry.name_);
+        size_t name_end = entry.name_.find_last_not_of(" \t\r");
+        entry.name_.erase((name_end == std::string::npos) ? 0 : (name_end + 1));
+        bool valid = (entry.name_.empty() == false) && (entry.bandwidth_ > 0);
+        entry.link_type_ = (type == "PCIe") ? LINK_TYPE_PCIE : LINK_TYPE_XGMI;
+        valid = (valid) && ((type == "PCIe") || (type == "xGMI"));
+        entry.hops_ = (hops == "*") ? 0xFFFFFFFF : atoi(hops.c_str());
+        if (valid == false) {
+            std::cout << "Illegal entry in health table: " << line << std::endl;
+            exit_test(1);
+        }
+        health_table_.push_back(entry);
+    }
+}
+
+double RocmBandwidthTest::GetExpectedBandwidth(uint32_t src_dev_idx, uint32_t dst_dev_idx) const {
+    uint32_t link_type = GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx);
+    uint32_t hops = GetLinkProp(LINK_PROP_HOPS, src_dev_idx, dst_dev_idx);
+
+    // Links to a Cpu are classified by name of the Gpu at other end
+    uint32_t name_idx = src_dev_idx;
+    if (agent_list_[src_dev_idx].device_type_ != HSA_DEVICE_TYPE_GPU) {
+        name_idx = dst_dev_idx;
+    }
+    std::string name(agent_list_[name_idx].name_);
+
+    // Entry that matches name and hops exactly is preferred over one
+    // that matches by wildcard. Name weighs more than hops
+    int32_t best_score = -1;
+    double expected = 0;
+    uint32_t count = health_table_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        const health_expect_t& entry = health_table_[idx];
+        if (entry.link_type_ != link_type) {
+            continue;
+        }
+        if ((entry.hops_ != 0xFFFFFFFF) && (entry.hops_ != hops)) {
+            continue;
+        }
+        if ((entry.name_ != "*") && (entry.name_ != name)) {
+            continue;
+        }
+        int32_t score = ((entry.name_ != "*") ? 2 : 0) + ((entry.hops_ != 0xFFFFFFFF) ? 1 : 0);
+        if (score > best_score) {
+            best_score = score;
+            expected = entry.bandwidth_;
+        }
+    }
+    return expected;
+}
+
+void RocmBandwidthTest::EvaluateHealth() {
+    if (health_ == false) {
+        return;
+    }
+
+    uint32_t cell_cnt = agent_index_ * agent_index_;
+    health_grade_.assign(cell_cnt, HEALTH_NONE);
+    health_expected_.assign(cell_cnt, 0);
+    health_status_ = HEALTH_PASS;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        uint32_t cell = (src_dev_idx * agent_index_) + dst_dev_idx;
+        double expected = GetExpectedBandwidth(src_dev_idx, dst_dev_idx);
+        if ((expected == 0) || (trans.peak_bandwidth_.empty())) {
+            continue;
+        }
+
+        // Grade by peak bandwidth as it is least affected by noise
+        double bandwidth = trans.peak_bandwidth_[0];
+        uint32_t grade = HEALTH_PASS;
+        if (bandwidth < (expected * health_fail_)) {
+            grade = HEALTH_FAIL;
+            RaiseExitValue(HEALTH_FAIL_EXIT_VALUE);
+        } else if (bandwidth < (expected * health_degraded_)) {
+            grade = HEALTH_DEGRADED;
+            RaiseExitValue(HEALTH_DEGRADED_EXIT_VALUE);
+        }
+        health_status_ = std::max(health_status_, grade);
+        // Devices with more than one pool are graded once per pool
+        // pair, so cell keeps the worst grade of them
+        health_grade_[cell] = std::max(health_grade_[cell], grade);
+        health_expected_[cell] = expected;
+    }
+}
+
+void RocmBandwidthTest::DisplayHealthMatrix() const {
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Link Health Check" << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "D/D";
+    format = 12;
+    for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+        std::cout.width(format);
+        std::cout << idx0;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    const char* grade_str[] = {"N/A", "PASS", "DEGRADED", "FAIL"};
+    for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+        format = 10;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << idx0;
+        format = 12;
+        for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
+            std::cout.width(format);
+            std::cout << grade_str[health_grade_[(idx0 * agent_index_) + idx1]];
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+    }
+
+    // List links that fell short of expected bandwidth
+    uint32_t trans_size = trans_list_.size();
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        uint32_t cell = (src_dev_idx * agent_index_) + dst_dev_idx;
+        uint32_t grade = health_grade_[cell];
+        if ((grade != HEALTH_DEGRADED) && (grade != HEALTH_FAIL)) {
+            continue;
+        }
+        uint32_t link_type = GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx);
+        std::cout.width(10);
+        std::cout << "";
+        std::cout << grade_str[grade] << ": Device " << src_dev_idx << " -> Device "
+                  << dst_dev_idx << ", " << trans.peak_bandwidth_[0] << " GB/s, expected "
+                  << health_expected_[cell] << " GB/s over "
+                  << ((link_type == LINK_TYPE_XGMI) ? "xGMI" : "PCIe") << " with "
+                  << GetLinkProp(LINK_PROP_HOPS, src_dev_idx, dst_dev_idx) << " hops" << std::endl;
+    }
+
+    std::cout.width(10);
+    std::cout << "";
+    std::cout << "Health: "
+              << ((health_status_ == HEALTH_FAIL)       ? "FAIL"
+                  : (health_status_ == HEALTH_DEGRADED) ? "DEGRADED"
+                                                        : "PASS")
+              << std::endl;
+    std::cout << std::endl;
+}
@@ -53,5 +53,5 @@
 
 void RocmBandwidthTest::RunIOBenchmark(async_trans_t& trans) {
     std::cout << "Unsupported Request - Read / Write" << std::endl;
-    exit(1);
+    exit_test(1);
 }
@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "json_writer.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <fstream>
+#include <iostream>
+
+static const char* getDeviceTypeString(hsa_device_type_t dev_type) {
+    switch (dev_type) {
+        case HSA_DEVICE_TYPE_CPU:
+            return "CPU";
+        case HSA_DEVICE_TYPE_GPU:
+            return "GPU";
+        default:
+            return "DSP";
+    }
+}
+
+static const char* getReqTypeString(uint32_t req_type) {
+    switch (req_type) {
+        case REQ_COPY_BIDIR:
+            return "bidir";
+        case REQ_COPY_UNIDIR:
+            return "unidir";
+        case REQ_COPY_ALL_BIDIR:
+            return "all_bidir";
+        case REQ_COPY_ALL_UNIDIR:
+            return "all_unidir";
+        case REQ_CONCURRENT_COPY_BIDIR:
+            return "concurrent_bidir";
+        case REQ_CONCURRENT_COPY_UNIDIR:
+            return "concurrent_unidir";
+        default:
+            return "invalid";
+    }
+}
+
+void RocmBandwidthTest::WriteJsonLinkValue(JsonWriter& json, uint32_t key,
+                                           uint32_t value) const {
+    if (key == LINK_PROP_ACCESS) {
+        json.Value(value);
+        return;
+    }
+    if (key == LINK_PROP_TYPE) {
+        if (value == LINK_TYPE_XGMI) {
+            json.Value("xGMI");
+        } else if (value == LINK_TYPE_PCIE) {
+            json.Value("PCIe");
+        } else {
+            json.Null();
+        }
+        return;
+    }
+    if (value == 0xFFFFFFFF) {
+        json.Null();
+        return;
+    }
+    json.Value(value);
+}
+
+void RocmBandwidthTest::WriteJsonPcieLinks(JsonWriter& json, uint32_t dev_idx) const {
+    if ((dev_idx >= pcie_links_.size()) || (pcie_links_[dev_idx].empty())) {
+        return;
+    }
+    json.Key("pcie_bandwidth");
+    json.Value(GetPcieBandwidth(dev_idx, false));
+    json.Key("pcie_links");
+    json.BeginArray();
+    const vector<pcie_link_t>& links = pcie_links_[dev_idx];
+    for (uint32_t idx = 0; idx < links.size(); idx++) {
+        json.BeginObject();
+        json.Key("address");
+        json.Value(links[idx].addr_);
+        json.Key("current_speed");
+        json.Value(links[idx].cur_speed_);
+        json.Key("current_width");
+        json.Value(links[idx].cur_width_);
+        json.Key("max_speed");
+        json.Value(links[idx].max_speed_);
+        json.Key("max_width");
+        json.Value(links[idx].max_width_);
+        json.EndObject();
+    }
+    json.EndArray();
+}
+
+void RocmBandwidthTest::WriteJsonTopology(JsonWriter& json) const {
+    json.Key("agents");
+    json.BeginArray();
+    size_t count = agent_pool_list_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        const agent_pool_info_t& node = agent_pool_list_[idx];
+        json.BeginObject();
+        json.Key("index");
+        json.Value(node.agent.index_);
+        json.Key("type");
+        json.Value(getDeviceTypeString(node.agent.device_type_));
+        json.Key("name");
+        json.Value(node.agent.name_);
+        if (node.agent.device_type_ == HSA_DEVICE_TYPE_GPU) {
+            json.Key("uuid");
+            json.Value(node.agent.uuid_);
+            json.Key("bdf");
+            json.Value(node.agent.bdf_id_);
+            WriteJsonPcieLinks(json, idx);
+        }
+        json.Key("pools");
+        json.BeginArray();
+        size_t pool_count = node.pool_list.size();
+        for (uint32_t jdx = 0; jdx < pool_count; jdx++) {
+            const pool_info_t& pool = node.pool_list[jdx];
+            json.BeginObject();
+            json.Key("index");
+            json.Value(pool.index_);
+            json.Key("size");
+            json.Value((uint64_t)pool.allocable_size_);
+            json.Key("fine_grained");
+            json.Value(pool.is_fine_grained_);
+            json.Key("access_to_all");
+            json.Value(pool.access_to_all_);
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+    json.EndArray();
+}
+
+void RocmBandwidthTest::WriteJsonLinks(JsonWriter& json) const {
+    const char* names[] = {"hops", "type", "weight", "access"};
+    const uint32_t keys[] = {LINK_PROP_HOPS, LINK_PROP_TYPE, LINK_PROP_WEIGHT, LINK_PROP_ACCESS};
+
+    // Each matrix is indexed by source and then destination agent
+    json.Key("links");
+    json.BeginObject();
+    for (uint32_t prop = 0; prop < 4; prop++) {
+        json.Key(names[prop]);
+        json.BeginArray();
+        for (uint32_t src_idx = 0; src_idx < agent_index_; src_idx++) {
+            json.BeginArray();
+            for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
+                uint32_t value = GetLinkProp(keys[prop], src_idx, dst_idx);
+                WriteJsonLinkValue(json, keys[prop], value);
+            }
+            json.EndArray();
+        }
+        json.EndArray();
+    }
+    json.EndObject();
+}
+
+void RocmBandwidthTest::WriteJsonTrans(JsonWriter& json, const async_trans_t& trans) const {
+    uint32_t src_idx = trans.copy.src_idx_;
+    uint32_t dst_idx = trans.copy.dst_idx_;
+    json.BeginObject();
+    json.Key("id");
+    json.Value(trans.trans_id_);
+    json.Key("type");
+    json.Value(getReqTypeString(trans.req_type_));
+    json.Key("src_agent");
+    json.Value(pool_list_[src_idx].agent_index_);
+    json.Key("src_pool");
+    json.Value(src_idx);
+    json.Key("dst_agent");
+    json.Value(pool_list_[dst_idx].agent_index_);
+    json.Key("dst_pool");
+    json.Value(dst_idx);
+    json.Key("bidir");
+    json.Value(trans.copy.bidir_);
+    json.Key("cpu_time");
+    json.Value((print_cpu_time_) || (trans.copy.uses_gpu_ == false));
+
+    // Times are reported in microseconds and bandwidth in GB/s
+    json.Key("results");
+    json.BeginArray();
+    uint32_t size_len = trans.size_list_.size();
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        bool valid = (trans.min_time_[idx] != VALIDATE_COPY_OP_FAILURE);
+        json.BeginObject();
+        json.Key("size");
+        json.Value((uint64_t)trans.size_list_[idx]);
+        json.Key("valid");
+        json.Value(valid);
+        if (valid == false) {
+            json.EndObject();
+            continue;
+        }
+        json.Key("avg_time_us");
+        json.Value(trans.avg_time_[idx] * 1e6);
+        json.Key("avg_bandwidth_gbps");
+        json.Value(trans.avg_bandwidth_[idx]);
+        json.Key("min_time_us");
+        json.Value(trans.min_time_[idx] * 1e6);
+        json.Key("peak_bandwidth_gbps");
+        json.Value(trans.peak_bandwidth_[idx]);
+        if ((print_stats_) && (idx < trans.stats_.size())) {
+            const stats_summary_t& stats = trans.stats_[idx];
+            json.Key("stats");
+            json.BeginObject();
+            json.Key("count");
+            json.Value(stats.count_);
+            json.Key("median_us");
+            json.Value(stats.median_ * 1e6);
+            json.Key("p90_us");
+            json.Value(stats.p90_ * 1e6);
+            json.Key("p99_us");
+            json.Value(stats.p99_ * 1e6);
+            json.Key("p999_us");
+            json.Value(stats.p999_ * 1e6);
+            json.Key("max_us");
+            json.Value(stats.max_ * 1e6);
+            json.Key("std_dev_us");
+            json.Value(stats.std_dev_ * 1e6);
+            json.Key("ci_low_us");
+            json.Value(stats.ci_low_ * 1e6);
+            json.Key("ci_high_us");
+            json.Value(stats.ci_high_ * 1e6);
+            json.EndObject();
+        }
+        json.EndObject();
+    }
+    json.EndArray();
+
+    if (trans.knee_size_ != 0) {
+        json.Key("knee");
+        json.BeginObject();
+        json.Key("fraction");
+        json.Value(knee_fraction_);
+        json.Key("size");
+        json.Value((uint64_t)trans.knee_size_);
+        json.Key("bandwidth_gbps");
+        json.Value(trans.knee_bandwidth_);
+        json.EndObject();
+    }
+    json.EndObject();
+}
+
+void RocmBandwidthTest::WriteJsonReport() const {
+    if (json_file_path_.empty()) {
+        return;
+    }
+
+    std::ofstream out(json_file_path_.c_str());
+    if (out.is_open() == false) {
+        std::cout << "Unable to create json file: " << json_file_path_ << std::endl;
+        exit_test(1);
+    }
+
+    JsonWriter json(out);
+    json.BeginObject();
+    json.Key("version");
+    json.Value(GetVersion());
+    json.Key("transport");
+    json.Value(transport_->GetName());
+    json.Key("command");
+    json.BeginArray();
+    for (uint32_t idx = 0; idx < usr_argc_; idx++) {
+        json.Value(usr_argv_[idx]);
+    }
+    json.EndArray();
+
+    WriteJsonTopology(json);
+    WriteJsonLinks(json);
+
+    // Time taken by each phase of topology discovery
+    json.Key("discovery_ms");
+    json.BeginObject();
+    for (uint32_t idx = 0; idx < discovery_phases_.size(); idx++) {
+        json.Key(discovery_phases_[idx].name_);
+        json.Value(discovery_phases_[idx].time_ms_);
+    }
+    json.EndObject();
+
+    // Read and write requests do not report results
+    json.Key("transactions");
+    json.BeginArray();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
+            continue;
+        }
+        WriteJsonTrans(json, trans);
+    }
+    json.EndArray();
+    json.EndObject();
+
+    out.close();
+    if (out.fail()) {
+        std::cout << "Failed to write json file: " << json_file_path_ << std::endl;
+        exit_test(1);
+    }
+}
@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// @brief: Parse list of Cpu's in sysfs format, e.g. 0-15,32-47
+static void parseCpuList(const std::string& list, vector<uint32_t>& cpus) {
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        uint32_t first = strtoul(range.c_str(), NULL, 10);
+        uint32_t last = first;
+        size_t pos = range.find('-');
+        if (pos != std::string::npos) {
+            last = strtoul(range.c_str() + pos + 1, NULL, 10);
+        }
+        for (uint32_t cpu = first; (cpu <= last) && (cpu < CPU_SETSIZE); cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+}
+
+void RocmBandwidthTest::DiscoverNumaNodes() {
+    // Runtime exposes one Cpu agent per NUMA node with Cpu's, whose
+    // node id is that of the NUMA node. Nodes without Cpu's have no
+    // agent, so agents can't be matched to nodes by their order
+    numa_cpus_.clear();
+    numa_cpus_.resize(agent_index_);
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        if (agent_list_[idx].device_type_ != HSA_DEVICE_TYPE_CPU) {
+            continue;
+        }
+        std::stringstream path;
+        path << sysfs_root_ << "/devices/system/node/node" << agent_list_[idx].node_id_
+             << "/cpulist";
+        std::ifstream in(path.str().c_str());
+        std::string list;
+        if ((in.is_open()) && (std::getline(in, list))) {
+            parseCpuList(list, numa_cpus_[idx]);
+        }
+    }
+}
+
+int32_t RocmBandwidthTest::GetNumaCpu(uint32_t gpu_dev_idx, bool far) const {
+    int32_t cpu_dev_idx = -1;
+    uint32_t cpu_weight = 0;
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        if ((agent_list_[idx].device_type_ != HSA_DEVICE_TYPE_CPU) ||
+            (agent_pool_list_[idx].pool_list.empty())) {
+            continue;
+        }
+        uint32_t weight = GetLinkProp(LINK_PROP_WEIGHT, idx, gpu_dev_idx);
+        if (weight == 0xFFFFFFFF) {
+            continue;
+        }
+        bool better = (far) ? (weight > cpu_weight) : (weight < cpu_weight);
+        if ((cpu_dev_idx == -1) || (better)) {
+            cpu_dev_idx = idx;
+            cpu_weight = weight;
+        }
+    }
+    return cpu_dev_idx;
+}
+
+bool RocmBandwidthTest::BuildNumaCopyTrans() {
+    for (uint32_t gpu_dev_idx = 0; gpu_dev_idx < agent_index_; gpu_dev_idx++) {
+        if ((agent_list_[gpu_dev_idx].device_type_ != HSA_DEVICE_TYPE_GPU) ||
+            (agent_pool_list_[gpu_dev_idx].pool_list.empty())) {
+            continue;
+        }
+        int32_t near_dev_idx = GetNumaCpu(gpu_dev_idx, false);
+        int32_t far_dev_idx = GetNumaCpu(gpu_dev_idx, true);
+        if (near_dev_idx == -1) {
+            continue;
+        }
+
+        // Far node is skipped on systems with a single node
+        const pool_info_t& gpu_pool = agent_pool_list_[gpu_dev_idx].pool_list[0];
+        for (uint32_t numa_class = NUMA_NEAR; numa_class <= NUMA_FAR; numa_class++) {
+            int32_t cpu_dev_idx = (numa_class == NUMA_NEAR) ? near_dev_idx : far_dev_idx;
+            if ((numa_class == NUMA_FAR) && (far_dev_idx == near_dev_idx)) {
+                continue;
+            }
+            const pool_info_t& cpu_pool = agent_pool_list_[cpu_dev_idx].pool_list[0];
+
+            // Build host to device copy followed by device to host copy
+            for (uint32_t dir = 0; dir < 2; dir++) {
+                const pool_info_t& src_pool = (dir == 0) ? cpu_pool : gpu_pool;
+                const pool_info_t& dst_pool = (dir == 0) ? gpu_pool : cpu_pool;
+                uint32_t src_dev_idx = src_pool.agent_index_;
+                uint32_t dst_dev_idx = dst_pool.agent_index_;
+                if (GetLinkProp(LINK_PROP_PATH, src_dev_idx, dst_dev_idx) == 0) {
+                    continue;
+                }
+
+                if (active_agents_list_ == NULL) {
+                    active_agents_list_ = new uint32_t[agent_index_]();
+                }
+                active_agents_list_[src_dev_idx] = 1;
+                active_agents_list_[dst_dev_idx] = 1;
+
+                async_trans_t trans(REQ_COPY_ALL_UNIDIR);
+                trans.copy.src_idx_ = src_pool.index_;
+                trans.copy.dst_idx_ = dst_pool.index_;
+                trans.copy.src_pool_ = src_pool.pool_;
+                trans.copy.dst_pool_ = dst_pool.pool_;
+                trans.copy.bidir_ = false;
+                trans.copy.uses_gpu_ = true;
+                trans.numa_class_ = numa_class;
+                trans.trans_id_ = trans_list_.size();
+                trans_list_.push_back(trans);
+            }
+        }
+    }
+    return true;
+}
+
+int32_t RocmBandwidthTest::GetCopyNumaCpu(const async_trans_t& trans) const {
+    // Host buffer determines the node, else Cpu nearest to source Gpu
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    if (agent_list_[src_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU) {
+        return src_dev_idx;
+    }
+    if (agent_list_[dst_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU) {
+        return dst_dev_idx;
+    }
+    return GetNumaCpu(src_dev_idx, false);
+}
+
+bool RocmBandwidthTest::BindThreadToNodes(const vector<int32_t>& cpu_dev_list,
+                                          cpu_set_t* saved) {
+    // Stay within Cpu's the process is allowed to run on, which
+    // may exclude the node when run under a restricted cpuset
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), saved) != 0) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (uint32_t jdx = 0; jdx < cpu_dev_list.size(); jdx++) {
+        if (cpu_dev_list[jdx] == -1) {
+            continue;
+        }
+        const vector<uint32_t>& node_cpus = numa_cpus_[cpu_dev_list[jdx]];
+        for (uint32_t idx = 0; idx < node_cpus.size(); idx++) {
+            if (CPU_ISSET(node_cpus[idx], saved)) {
+                CPU_SET(node_cpus[idx], &cpus);
+            }
+        }
+    }
+    if (CPU_COUNT(&cpus) == 0) {
+        return false;
+    }
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus) == 0);
+}
+
+bool RocmBandwidthTest::BindCopyThread(const async_trans_t& trans, cpu_set_t* saved) {
+    vector<int32_t> cpu_dev_list(1, GetCopyNumaCpu(trans));
+    return BindThreadToNodes(cpu_dev_list, saved);
+}
+
+bool RocmBandwidthTest::BindCopyThread(const vector<async_trans_t>& trans_list,
+                                       cpu_set_t* saved) {
+    // One thread submits copies of the group, so it runs on the
+    // nodes of all of them
+    vector<int32_t> cpu_dev_list;
+    for (uint32_t idx = 0; idx < trans_list.size(); idx++) {
+        cpu_dev_list.push_back(GetCopyNumaCpu(trans_list[idx]));
+    }
+    return BindThreadToNodes(cpu_dev_list, saved);
+}
+
+void RocmBandwidthTest::DisplayNumaMatrix() const {
+    // Collect peak bandwidth at largest size, indexed by Gpu,
+    // placement and direction, and Cpu agent of each placement
+    uint32_t cell_cnt = agent_index_ * 4;
+    vector<double> bandwidth(cell_cnt, 0);
+    vector<int32_t> cpu_dev(agent_index_ * 2, -1);
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.numa_class_ == NUMA_NONE) || (trans.peak_bandwidth_.empty())) {
+            continue;
+        }
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        bool h2d = (agent_list_[src_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU);
+        uint32_t gpu_dev_idx = (h2d) ? dst_dev_idx : src_dev_idx;
+        uint32_t place = (trans.numa_class_ == NUMA_NEAR) ? 0 : 1;
+        bandwidth[(gpu_dev_idx * 4) + (place * 2) + ((h2d) ? 0 : 1)] = trans.peak_bandwidth_.back();
+        cpu_dev[(gpu_dev_idx * 2) + place] = (h2d) ? src_dev_idx : dst_dev_idx;
+    }
+
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Peak bandwidth GB/s with host buffer on nearest and farthest NUMA node"
+              << std::endl;
+    std::cout << std::endl;
+
+    const char* header[] = {"Gpu", "Near", "H2D", "D2H", "Far", "H2D", "D2H"};
+    std::cout.width(format);
+    std::cout << "";
+    for (uint32_t idx = 0; idx < 7; idx++) {
+        std::cout.width(format);
+        std::cout << header[idx];
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    for (uint32_t gpu_dev_idx = 0; gpu_dev_idx < agent_index_; gpu_dev_idx++) {
+        if (cpu_dev[gpu_dev_idx * 2] == -1) {
+            continue;
+        }
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << gpu_dev_idx;
+        for (uint32_t place = 0; place < 2; place++) {
+            int32_t cpu_dev_idx = cpu_dev[(gpu_dev_idx * 2) + place];
+            std::cout.width(format);
+            if (cpu_dev_idx == -1) {
+                std::cout << "N/A";
+            } else {
+                std::cout << cpu_dev_idx;
+            }
+            for (uint32_t dir = 0; dir < 2; dir++) {
+                double value = bandwidth[(gpu_dev_idx * 4) + (place * 2) + dir];
+                std::cout.width(format);
+                if (value == 0) {
+                    std::cout << "N/A";
+                } else {
+                    std::cout << value;
+                }
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
@@ -113,78 +113,86 @@ static bool ParseOptionValue(char* value, vector<size_t>& value_list) {
     return true;
 }
 
-void RocmBandwidthTest::ValidateCopyBidirFlags(uint32_t copy_ctrl_mask) {
+bool RocmBandwidthTest::ValidateCopyBidirFlags(uint32_t copy_ctrl_mask) {
     // It is illegal to specify following flags
     // secondary flag that affects a copy operation
     if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & CPU_VISIBLE_TIME) ||
         (copy_ctrl_mask & VALIDATE_COPY_OP)) {
-        PrintHelpScreen();
-        exit(0);
+        return false;
+    }
+
+    // It is illegal to specify user buffer sizes
+    // when sizes are picked by an adaptive sweep
+    if ((copy_ctrl_mask & ADAPTIVE_SWEEP) && (copy_ctrl_mask & USR_BUFFER_SIZE)) {
+        return false;
     }
 
-    return;
+    return true;
 }
 
-void RocmBandwidthTest::ValidateCopyUnidirFlags(uint32_t copy_mask, uint32_t copy_ctrl_mask) {
+bool RocmBandwidthTest::ValidateCopyUnidirFlags(uint32_t copy_mask, uint32_t copy_ctrl_mask) {
     if (copy_mask != (USR_SRC_FLAG | USR_DST_FLAG)) {
-        PrintHelpScreen();
-        exit(0);
+        return false;
     }
 
     if ((copy_ctrl_mask & DEV_COPY_LATENCY) && (copy_ctrl_mask & USR_BUFFER_SIZE)) {
-        PrintHelpScreen();
-        exit(0);
+        return false;
     }
 
     // It is illegal to specify Latency and another
     // secondary flag that affects a copy operation
     if ((copy_ctrl_mask & DEV_COPY_LATENCY) && (copy_ctrl_mask & VALIDATE_COPY_OP)) {
-        PrintHelpScreen();
-        exit(0);
+        return false;
     }
 
     // It is illegal to specify user buffer sizes and another
     // secondary flag that affects a copy operation
     if ((copy_ctrl_mask & USR_BUFFER_SIZE) && (copy_ctrl_mask & VALIDATE_COPY_OP)) {
-        PrintHelpScreen();
-        exit(0);
+        return false;
+    }
+
+    // It is illegal to specify adaptive sweep and another
+    // secondary flag that determines the buffer sizes
+    if ((copy_ctrl_mask & ADAPTIVE_SWEEP) &&
+        ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_SIZE) ||
+         (copy_ctrl_mask & VALIDATE_COPY_OP))) {
+        return false;
     }
 
     // Check of illegal flags is complete
-    return;
+    return true;
 }
 
-void RocmBandwidthTest::ValidateCopyAllBidirFlags(uint32_t copy_ctrl_mask) {
+bool RocmBandwidthTest::ValidateCopyAllBidirFlags(uint32_t copy_ctrl_mask) {
     // It is illegal to specify following flags
     // secondary flag that affects a copy operation
     if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_SIZE) ||
-        (copy_ctrl_mask & CPU_VISIBLE_TIME) || (copy_ctrl_mask & VALIDATE_COPY_OP)) {
-        PrintHelpScreen();
-        exit(0);
+        (copy_ctrl_mask & CPU_VISIBLE_TIME) || (copy_ctrl_mask & VALIDATE_COPY_OP) ||
+        (copy_ctrl_mask & ADAPTIVE_SWEEP)) {
+        return false;
     }
 
     // Check of illegal flags is complete
-    return;
+    return true;
 }
 
-void RocmBandwidthTest::ValidateCopyAllUnidirFlags(uint32_t copy_ctrl_mask) {
+bool RocmBandwidthTest::ValidateCopyAllUnidirFlags(uint32_t copy_ctrl_mask) {
     // It is illegal to specify following flags
     // secondary flag that affects a copy operation
-    if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_SIZE)) {
-        PrintHelpScreen();
-        exit(0);
+    if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_SIZE) ||
+        (copy_ctrl_mask & ADAPTIVE_SWEEP)) {
+        return false;
     }
 
     // Check of illegal flags is complete
-    return;
+    return true;
 }
 
-void RocmBandwidthTest::ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask,
+bool RocmBandwidthTest::ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask,
                                            uint32_t copy_ctrl_mask) {
     // Input can't have more than two Primary flags
     if ((pf_cnt == 0) || (pf_cnt > 2)) {
-        PrintHelpScreen();
-        exit(0);
+        return false;
     }
 
     // Input specifies unidirectional copy among subset of devices
@@ -197,19 +205,19 @@ void RocmBandwidthTest::ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask,
     // rocm_bandwidth_test -q
     if (req_version_ == REQ_VERSION) {
         PrintVersion();
-        exit(0);
+        exit_test(0);
     }
 
     // Input is requesting to print ROCm topology
     // rocm_bandwidth_test -t
     if (req_topology_ == REQ_TOPOLOGY) {
-        return;
+        return true;
     }
 
     // Input is requesting to print list of devices
     // rocm_bandwidth_test -e
     if (req_list_devs_ == REQ_LIST_DEVS) {
-        return;
+        return true;
     }
 
     // Input is for bidirectional bandwidth for some devices
@@ -231,22 +239,21 @@ void RocmBandwidthTest::ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask,
     }
 
     // Input is requesting to run concurrent copies
-    // rocm_bandwidth_test -k or -K
+    // rocm_bandwidth_test -k, -K, -F or -I
     // It is illegal to specify secondary flags
     if ((req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
         (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR)) {
         if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_INIT) ||
             (copy_ctrl_mask & USR_BUFFER_SIZE) || (copy_ctrl_mask & CPU_VISIBLE_TIME) ||
-            (copy_ctrl_mask & VALIDATE_COPY_OP)) {
-            PrintHelpScreen();
-            exit(0);
+            (copy_ctrl_mask & VALIDATE_COPY_OP) || (copy_ctrl_mask & ADAPTIVE_SWEEP)) {
+            return false;
         }
-        return;
+        return true;
     }
 
     std::cout << "ValidateInputFlags: This should not be happening" << std::endl;
     assert(false);
-    return;
+    return true;
 }
 
 void RocmBandwidthTest::BuildDeviceList() {
@@ -305,13 +312,20 @@ void RocmBandwidthTest::BuildBufferList() {
             size_list_.push_back(SIZE_LIST[idx]);
         }
     }
+
+    // Extend full list of sizes by doubling its last size
+    // up to the largest one user has asked for
+    if ((sweep_max_size_ == 0) || (latency_) || (size_list_.size() != size_len)) {
+        return;
+    }
+    for (size_t size = (size_list_.back() * 2); size <= sweep_max_size_; size *= 2) {
+        size_list_.push_back(size);
+    }
 }
 
-void RocmBandwidthTest::ParseArguments() {
+bool RocmBandwidthTest::ParseOptions(uint32_t& num_primary_flags, uint32_t& copy_mask,
+                                     uint32_t& copy_ctrl_mask) {
     bool print_help = 0;
-    uint32_t copy_mask = 0;
-    uint32_t copy_ctrl_mask = 0;
-    uint32_t num_primary_flags = 0;
 
     // This will suppress prints from getopt implementation
     // In case of error, it will return the character '?' as
@@ -320,7 +334,8 @@ void RocmBandwidthTest::ParseArguments() {
 
     int opt;
     bool status;
-    while ((opt = getopt(usr_argc_, usr_argv_, "hqteclvaAb:i:s:d:r:w:m:k:K:")) != -1) {
+    while ((opt = getopt(usr_argc_, usr_argv_,
+                         "hqteclvnpaASDHNb:i:s:d:r:w:m:k:K:F:I:R:j:G:P:B:C:f:T:")) != -1) {
         switch (opt) {
             // Print help screen
             case 'h':
@@ -351,6 +366,22 @@ void RocmBandwidthTest::ParseArguments() {
                 req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
                 break;
 
+            // Enable health check, which copies among all valid
+            // buffers and grades them against expected bandwidth
+            case 'H':
+                num_primary_flags++;
+                health_ = true;
+                req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+                break;
+
+            // Enable copies between every Gpu and its nearest and
+            // farthest Cpu agents to compare host buffer placement
+            case 'N':
+                num_primary_flags++;
+                numa_ = true;
+                req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+                break;
+
             // Enable Bidirectional copy among all valid buffers
             case 'A':
                 num_primary_flags++;
@@ -408,6 +439,20 @@ void RocmBandwidthTest::ParseArguments() {
                 print_help = true;
                 break;
 
+            // Collect device copies fan out of or into, followed
+            // by devices at the other end of the copies if any
+            case 'F':
+            case 'I':
+                status = ParseOptionValue(optarg, fan_list_);
+                if (status) {
+                    num_primary_flags++;
+                    fan_mode_ = (opt == 'F') ? FAN_OUT : FAN_IN;
+                    req_concurrent_copy_unidir_ = REQ_CONCURRENT_COPY_UNIDIR;
+                    break;
+                }
+                print_help = true;
+                break;
+
             // Size of buffers to use in copy and read/write operations
             case 'm':
                 status = ParseOptionValue(optarg, size_list_);
@@ -430,6 +475,67 @@ void RocmBandwidthTest::ParseArguments() {
                 copy_ctrl_mask |= DEV_COPY_LATENCY;
                 break;
 
+            // Plan requests and estimate their needs without running them
+            case 'n':
+                dry_run_ = true;
+                break;
+
+            // Collect and print statistics of copy times
+            case 'p':
+                print_stats_ = true;
+                break;
+
+            // Export copy time of every iteration into a file
+            case 'R':
+                sample_file_path_ = optarg;
+                break;
+
+            // Write results in JSON format into a file
+            case 'j':
+                json_file_path_ = optarg;
+                break;
+
+            // Write topology as a DOT or GraphML graph into a file
+            case 'G':
+                graph_file_path_ = optarg;
+                break;
+
+            // Write results in Prometheus format into a directory
+            case 'P':
+                prom_dir_path_ = optarg;
+                break;
+
+            // Save results as baseline into a file
+            case 'B':
+                baseline_save_path_ = optarg;
+                break;
+
+            // Compare results with baseline read from a file
+            case 'C':
+                baseline_cmp_path_ = optarg;
+                break;
+
+            // Run scenarios listed in a plan file
+            case 'f':
+                plan_file_path_ = optarg;
+                break;
+
+            // Replay transfers of a trace file
+            case 'T':
+                trace_file_path_ = optarg;
+                break;
+
+            // Run requests periodically as a daemon
+            case 'D':
+                daemon_ = true;
+                break;
+
+            // Set adaptive sweep mode flag to true
+            case 'S':
+                adaptive_ = true;
+                copy_ctrl_mask |= ADAPTIVE_SWEEP;
+                break;
+
             // Set validation mode flag to true
             case 'v':
                 validate_ = true;
@@ -470,9 +576,11 @@ void RocmBandwidthTest::ParseArguments() {
             case '?':
                 std::cout << "Argument is illegal or needs value: " << '?' << std::endl;
                 if ((optopt == 'b') || (optopt == 's') || (optopt == 'd') || (optopt == 'm') ||
-                    (optopt == 'i') || (false)) {
-                    std::cout << "Error: Options -b -s -d -m -i -k and -K require argument"
-                              << std::endl;
+                    (optopt == 'i') || (optopt == 'F') || (optopt == 'I') || (optopt == 'R') ||
+                    (optopt == 'j') || (optopt == 'G') || (optopt == 'P') || (optopt == 'B') ||
+                    (optopt == 'C') || (optopt == 'f') || (optopt == 'T') || (false)) {
+                    std::cout << "Error: Options -b -s -d -m -i -k -K -F -I -R -j -G -P -B -C -f "
+                              << "and -T require argument" << std::endl;
                 }
                 print_help = true;
                 break;
@@ -482,17 +590,96 @@ void RocmBandwidthTest::ParseArguments() {
         }
     }
 
+    return (print_help == false);
+}
+
+void RocmBandwidthTest::CheckOptions() {
+    // Baselines are built from statistics of copy times, which
+    // validation mode does not collect as it runs one iteration
+    bool baseline = (baseline_save_path_.empty() == false) || (baseline_cmp_path_.empty() == false);
+    if ((baseline) && (validate_)) {
+        std::cout << "Options -B and -C can't be used with option -v" << std::endl;
+        exit_test(1);
+    }
+    collect_stats_ = (print_stats_) || (baseline);
+
+    // Health check is meant to be fast, so it runs fewer
+    // iterations unless user has specified their number
+    if (health_) {
+        if (bw_iter_cnt_ == NULL) {
+            set_num_iteration(HEALTH_ITER_CNT);
+        }
+        LoadHealthTable();
+    }
+
+    // Daemon runs until terminated, so it can't export samples of
+    // every iteration nor save a baseline. Validation has no timing.
+    // Adaptive sweeps pick new sizes every run, which would leave
+    // windows of sizes that are never measured again
+    if ((daemon_) && ((sample_file_path_.empty() == false) ||
+                      (baseline_save_path_.empty() == false) || (validate_) || (adaptive_))) {
+        std::cout << "Option -D can't be used with options -R -B -S and -v" << std::endl;
+        exit_test(1);
+    }
+    if ((daemon_) && (bw_daemon_log_ != NULL)) {
+        daemon_log_.open(bw_daemon_log_, std::ios::app);
+        if (daemon_log_.is_open() == false) {
+            std::cout << "Unable to open daemon log: " << bw_daemon_log_ << std::endl;
+            exit_test(1);
+        }
+    }
+
+    // Exporter mode refreshes the Prometheus file and runs until
+    // terminated, so samples of every iteration are not exported
+    if ((export_interval_ != 0) && (prom_dir_path_.empty())) {
+        std::cout << "ROCM_BW_EXPORT_INTERVAL requires option -P" << std::endl;
+        exit_test(1);
+    }
+    if ((export_interval_ != 0) && (sample_file_path_.empty() == false)) {
+        std::cout << "ROCM_BW_EXPORT_INTERVAL can't be used with option -R" << std::endl;
+        exit_test(1);
+    }
+}
+
+void RocmBandwidthTest::ParseArguments() {
+    uint32_t copy_mask = 0;
+    uint32_t copy_ctrl_mask = 0;
+    uint32_t num_primary_flags = 0;
+
     // Print help screen if user option has "-h"
-    if (print_help) {
+    if (ParseOptions(num_primary_flags, copy_mask, copy_ctrl_mask) == false) {
         PrintHelpScreen();
-        exit(0);
+        exit_test(0);
     }
 
-    // Determine input of primary flags is valid
-    ValidateInputFlags(num_primary_flags, copy_mask, copy_ctrl_mask);
+    // Scenarios of a plan file bring their own options, which
+    // are parsed and validated as each of them is run
+    if (plan_file_path_.empty() == false) {
+        if (usr_argc_ > ((dry_run_) ? 4U : 3U)) {
+            std::cout << "Option -f can't be used with options other than -n" << std::endl;
+            exit_test(1);
+        }
+        LoadPlan();
+    } else if (trace_file_path_.empty() == false) {
+        // Trace brings its own transfers, devices and sizes
+        if (usr_argc_ > 3) {
+            std::cout << "Option -T can't be used with other options" << std::endl;
+            exit_test(1);
+        }
+        LoadTrace();
+    } else if (usr_argc_ == 1) {
+        LoadDefaultPlan();
+    } else {
+        // Determine input of primary flags is valid
+        if (ValidateInputFlags(num_primary_flags, copy_mask, copy_ctrl_mask) == false) {
+            PrintHelpScreen();
+            exit_test(0);
+        }
+        CheckOptions();
+    }
 
     // Initialize Roc Runtime
-    err_ = hsa_init();
+    err_ = transport_->Init();
     ErrorCheck(err_);
 
     // Discover the topology of RocR agent in system
@@ -502,7 +689,10 @@ void RocmBandwidthTest::ParseArguments() {
     if (req_list_devs_ == REQ_LIST_DEVS) {
         PrintVersion();
         PrintTopology();
-        exit(0);
+        PrintDiscoveryTime();
+        WriteJsonReport();
+        WriteGraphReport();
+        exit_test(0);
     }
 
     // Print system topology if user option is "-t"
@@ -512,9 +702,27 @@ void RocmBandwidthTest::ParseArguments() {
         PrintLinkPropsMatrix(LINK_PROP_ACCESS);
         PrintLinkPropsMatrix(LINK_PROP_TYPE);
         PrintLinkPropsMatrix(LINK_PROP_WEIGHT);
-        exit(0);
+        PrintDiscoveryTime();
+        WriteJsonReport();
+        WriteGraphReport();
+        exit_test(0);
+    }
+
+    // Transactions of a plan are built as each scenario is run
+    if (plan_list_.empty() == false) {
+        return;
+    }
+
+    // Transfers of a trace are replayed instead of transactions
+    if (trace_list_.empty() == false) {
+        ValidateTrace();
+        return;
     }
 
+    BuildRequestLists();
+}
+
+void RocmBandwidthTest::BuildRequestLists() {
     // Initialize devices list if copying unidirectional
     // all or bidirectional all mode is enabled
     if ((req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) ||
@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <limits.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// @brief: Return first line of a sysfs attribute, empty if it is absent
+static std::string readSysfsAttr(const std::string& path) {
+    std::string value;
+    std::ifstream in(path.c_str());
+    if (in.is_open()) {
+        std::getline(in, value);
+    }
+    return value;
+}
+
+// @brief: Determine if name is a PCI address of form dddd:bb:dd.f
+static bool isPciAddr(const std::string& name) {
+    return (name.size() == 12) && (name[4] == ':') && (name[7] == ':') && (name[10] == '.');
+}
+
+// @brief: Return theoretical bandwidth in GB/s of one direction of
+// a PCIe link. Gen1/2 use 8b/10b encoding, Gen3 to Gen5 128b/130b and
+// Gen6 carries 236 bytes of payload in every 256 byte FLIT
+static double getLinkBandwidth(double speed, uint32_t width) {
+    double encoding = 128.0 / 130.0;
+    if (speed <= 5.0) {
+        encoding = 8.0 / 10.0;
+    } else if (speed > 32.0) {
+        encoding = 236.0 / 256.0;
+    }
+    return (speed * width * encoding) / 8;
+}
+
+// @brief: Print speed and width of a PCIe link, e.g. 16.0 GT/s x16
+static void printLinkState(double speed, uint32_t width) {
+    std::cout.precision(1);
+    std::cout << std::fixed << speed << " GT/s x" << width;
+}
+
+// @brief: Read state of a PCIe link from its sysfs directory. Kernel
+// reports speed as "16.0 GT/s PCIe" and width as a plain integer
+static bool readPcieLink(const std::string& dir, const std::string& addr, pcie_link_t* link) {
+    std::string cur_speed = readSysfsAttr(dir + "/current_link_speed");
+    std::string cur_width = readSysfsAttr(dir + "/current_link_width");
+    if ((cur_speed.empty()) || (cur_width.empty())) {
+        return false;
+    }
+    link->addr_ = addr;
+    link->cur_speed_ = strtod(cur_speed.c_str(), NULL);
+    link->cur_width_ = strtoul(cur_width.c_str(), NULL, 10);
+    link->max_speed_ = strtod(readSysfsAttr(dir + "/max_link_speed").c_str(), NULL);
+    link->max_width_ = strtoul(readSysfsAttr(dir + "/max_link_width").c_str(), NULL, 10);
+    return true;
+}
+
+void RocmBandwidthTest::DiscoverPcieLinks() {
+    pcie_links_.clear();
+    pcie_links_.resize(agent_index_);
+    for (uint32_t idx = 0; idx < agent_index_; idx++) {
+        const agent_info_t& agent = agent_list_[idx];
+        if (agent.device_type_ != HSA_DEVICE_TYPE_GPU) {
+            continue;
+        }
+
+        // Device directory is a link into the tree of devices, whose
+        // parent directories are the bridges upstream of the device
+        std::stringstream addr;
+        addr << std::hex << std::setfill('0') << std::setw(4) << agent.domain_ << ":"
+             << agent.bdf_id_;
+        std::string path = sysfs_root_ + "/bus/pci/devices/" + addr.str();
+        char resolved[PATH_MAX];
+        if (realpath(path.c_str(), resolved) == NULL) {
+            continue;
+        }
+
+        // Walk upwards until root complex, whose directory is not
+        // named by a PCI address and carries no link state
+        std::string dir(resolved);
+        while (true) {
+            size_t pos = dir.find_last_of('/');
+            if (pos == std::string::npos) {
+                break;
+            }
+            std::string name = dir.substr(pos + 1);
+            pcie_link_t link;
+            if ((isPciAddr(name) == false) || (readPcieLink(dir, name, &link) == false)) {
+                break;
+            }
+            pcie_links_[idx].push_back(link);
+            dir = dir.substr(0, pos);
+        }
+    }
+}
+
+double RocmBandwidthTest::GetPcieBandwidth(uint32_t dev_idx, bool max) const {
+    if (dev_idx >= pcie_links_.size()) {
+        return 0;
+    }
+
+    // Path is only as fast as its narrowest link
+    double bandwidth = 0;
+    uint32_t count = pcie_links_[dev_idx].size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        const pcie_link_t& link = pcie_links_[dev_idx][idx];
+        double speed = (max) ? link.max_speed_ : link.cur_speed_;
+        uint32_t width = (max) ? link.max_width_ : link.cur_width_;
+        if ((speed == 0) || (width == 0)) {
+            continue;
+        }
+        double value = getLinkBandwidth(speed, width);
+        if ((bandwidth == 0) || (value < bandwidth)) {
+            bandwidth = value;
+        }
+    }
+    return bandwidth;
+}
+
+void RocmBandwidthTest::DisplayPcieLinkInfo() const {
+    bool found = false;
+    for (uint32_t idx = 0; idx < pcie_links_.size(); idx++) {
+        found = (found) || (pcie_links_[idx].empty() == false);
+    }
+    if (found == false) {
+        return;
+    }
+
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "PCIe link state" << std::endl;
+    std::cout << std::endl;
+
+    for (uint32_t idx = 0; idx < pcie_links_.size(); idx++) {
+        const vector<pcie_link_t>& links = pcie_links_[idx];
+        if (links.empty()) {
+            continue;
+        }
+        std::cout.width(format);
+        std::cout << "";
+        std::cout << "Device: " << idx << ",  " << links[0].addr_ << ",  ";
+        printLinkState(links[0].cur_speed_, links[0].cur_width_);
+        std::cout.precision(3);
+        std::cout << ",  " << GetPcieBandwidth(idx, false) << " GB/s";
+        double max_bandwidth = GetPcieBandwidth(idx, true);
+        if (max_bandwidth > 0) {
+            std::cout << " of " << max_bandwidth << " GB/s";
+        }
+        std::cout << std::endl;
+
+        // Flag every link on the path that trained below its capability
+        for (uint32_t jdx = 0; jdx < links.size(); jdx++) {
+            const pcie_link_t& link = links[jdx];
+            if ((link.cur_speed_ >= link.max_speed_) && (link.cur_width_ >= link.max_width_)) {
+                continue;
+            }
+            std::cout.width(format * 2);
+            std::cout << "";
+            std::cout << "Downtrained: " << link.addr_ << " at ";
+            printLinkState(link.cur_speed_, link.cur_width_);
+            std::cout << ", capable of ";
+            printLinkState(link.max_speed_, link.max_width_);
+            std::cout << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void RocmBandwidthTest::DisplayPcieEfficiency() const {
+    // Efficiency applies only to copies between a Cpu and a Gpu
+    // whose PCIe path is known. Bidirectional copies move twice the
+    // data of a unidirectional one over the same link
+    double* perf_matrix = new double[agent_index_ * agent_index_]();
+    PopulatePerfMatrix(true, perf_matrix);
+    double scale = (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) ? 2 : 1;
+    bool found = false;
+    for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+        for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
+            uint32_t cell = (idx0 * agent_index_) + idx1;
+            bool cpu0 = (agent_list_[idx0].device_type_ == HSA_DEVICE_TYPE_CPU);
+            bool cpu1 = (agent_list_[idx1].device_type_ == HSA_DEVICE_TYPE_CPU);
+            double bandwidth = 0;
+            if ((cpu0) && (cpu1 == false)) {
+                bandwidth = GetPcieBandwidth(idx1, false);
+            } else if ((cpu0 == false) && (cpu1)) {
+                bandwidth = GetPcieBandwidth(idx0, false);
+            }
+            if (bandwidth == 0) {
+                perf_matrix[cell] = 0;
+                continue;
+            }
+            perf_matrix[cell] = (perf_matrix[cell] * 100) / (bandwidth * scale);
+            found = (found) || (perf_matrix[cell] != 0);
+        }
+    }
+    if (found == false) {
+        delete[] perf_matrix;
+        return;
+    }
+
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "PCIe efficiency of peak bandwidth %" << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "D/D";
+    format = 12;
+    for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+        std::cout.width(format);
+        std::cout << idx0;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(1);
+    std::cout << std::fixed;
+    for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+        format = 10;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << idx0;
+        format = 12;
+        for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
+            std::cout.width(format);
+            double value = perf_matrix[(idx0 * agent_index_) + idx1];
+            if (value == 0) {
+                std::cout << "N/A";
+            } else {
+                std::cout << value;
+            }
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    delete[] perf_matrix;
+}
@@ -0,0 +1,359 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+// Mode of a scenario and the option it stands for. Modes that
+// work on a list of devices take it from key "devices"
+typedef struct plan_mode {
+        const char* name_;
+        const char* option_;
+        bool devices_;
+} plan_mode_t;
+
+static const plan_mode_t PLAN_MODES[] = {{"unidir", "", false},
+                                         {"bidir", "-b", true},
+                                         {"all_unidir", "-a", false},
+                                         {"all_bidir", "-A", false},
+                                         {"concurrent_unidir", "-k", true},
+                                         {"concurrent_bidir", "-K", true},
+                                         {"fan_out", "-F", true},
+                                         {"fan_in", "-I", true},
+                                         {"health", "-H", false},
+                                         {"numa", "-N", false}};
+
+// Keys of a scenario that switch an option on or off
+static const char* PLAN_FLAG_KEYS[][2] = {{"validate", "-v"}, {"latency", "-l"},
+                                          {"cpu_time", "-c"}, {"stats", "-p"},
+                                          {"sweep", "-S"}};
+
+// Keys of a scenario that pass their value to an option
+static const char* PLAN_VALUE_KEYS[][2] = {{"src", "-s"},      {"dst", "-d"},
+                                           {"sizes", "-m"},    {"pattern", "-i"},
+                                           {"json", "-j"},     {"graph", "-G"},
+                                           {"samples", "-R"},  {"baseline", "-B"},
+                                           {"compare", "-C"}};
+
+static std::string trimPlanString(const std::string& str) {
+    const char* space = " \t\r\n";
+    size_t first = str.find_first_not_of(space);
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = str.find_last_not_of(space);
+    return str.substr(first, (last - first) + 1);
+}
+
+static void exitPlanError(const std::string& path, uint32_t line, const std::string& msg) {
+    std::cout << "Plan file " << path << ", line " << line << ": " << msg << std::endl;
+    exit_test(1);
+}
+
+// Add key of a scenario, returns false if key is unknown or
+// its value is illegal
+static bool addPlanKey(plan_scenario_t& scenario, const std::string& key,
+                       const std::string& value) {
+    if (key == "mode") {
+        scenario.mode_ = value;
+        return true;
+    }
+    if (key == "devices") {
+        scenario.devices_ = value;
+        return true;
+    }
+    if (key == "iterations") {
+        char* end = NULL;
+        long num = strtol(value.c_str(), &end, 10);
+        if ((*end != '\0') || (num < 1) || (num > 1000000)) {
+            return false;
+        }
+        scenario.iter_cnt_ = num;
+        return true;
+    }
+
+    uint32_t count = sizeof(PLAN_FLAG_KEYS) / sizeof(PLAN_FLAG_KEYS[0]);
+    for (uint32_t idx = 0; idx < count; idx++) {
+        if (key != PLAN_FLAG_KEYS[idx][0]) {
+            continue;
+        }
+        if (value == "true") {
+            scenario.args_.push_back(PLAN_FLAG_KEYS[idx][1]);
+            return true;
+        }
+        return (value == "false");
+    }
+
+    count = sizeof(PLAN_VALUE_KEYS) / sizeof(PLAN_VALUE_KEYS[0]);
+    for (uint32_t idx = 0; idx < count; idx++) {
+        if (key == PLAN_VALUE_KEYS[idx][0]) {
+            scenario.args_.push_back(PLAN_VALUE_KEYS[idx][1]);
+            scenario.args_.push_back(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+void RocmBandwidthTest::LoadPlan() {
+    std::ifstream in(plan_file_path_.c_str());
+    if (in.is_open() == false) {
+        std::cout << "Unable to open plan file: " << plan_file_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Scenarios begin with their name in brackets and are followed
+    // by lines of key = value. Lines starting with # or ; are comments
+    std::string line;
+    uint32_t line_num = 0;
+    vector<uint32_t> line_list;
+    while (std::getline(in, line)) {
+        line_num++;
+        line = trimPlanString(line);
+        if ((line.empty()) || (line[0] == '#') || (line[0] == ';')) {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            std::string name = trimPlanString(line.substr(1, line.size() - 1));
+            if ((line[line.size() - 1] != ']') || (name.size() < 2)) {
+                exitPlanError(plan_file_path_, line_num, "Illegal name of scenario");
+            }
+            plan_scenario_t scenario;
+            scenario.name_ = trimPlanString(name.substr(0, name.size() - 1));
+            plan_list_.push_back(scenario);
+            line_list.push_back(line_num);
+            continue;
+        }
+
+        size_t pos = line.find('=');
+        if ((pos == std::string::npos) || (plan_list_.empty())) {
+            exitPlanError(plan_file_path_, line_num, "Expected [scenario] or key = value");
+        }
+        std::string key = trimPlanString(line.substr(0, pos));
+        std::string value = trimPlanString(line.substr(pos + 1));
+        if ((value.empty()) || (addPlanKey(plan_list_.back(), key, value) == false)) {
+            exitPlanError(plan_file_path_, line_num, "Unknown key or illegal value: " + line);
+        }
+    }
+
+    if (plan_list_.empty()) {
+        std::cout << "Plan file has no scenarios: " << plan_file_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Option of mode goes first, followed by its list of devices
+    uint32_t mode_cnt = sizeof(PLAN_MODES) / sizeof(PLAN_MODES[0]);
+    uint32_t plan_size = plan_list_.size();
+    for (uint32_t idx = 0; idx < plan_size; idx++) {
+        plan_scenario_t& scenario = plan_list_[idx];
+        const plan_mode_t* mode = NULL;
+        for (uint32_t jdx = 0; jdx < mode_cnt; jdx++) {
+            if (scenario.mode_ == PLAN_MODES[jdx].name_) {
+                mode = &PLAN_MODES[jdx];
+            }
+        }
+        if (mode == NULL) {
+            exitPlanError(plan_file_path_, line_list[idx],
+                          "Unknown mode of scenario " + scenario.name_ + ": " + scenario.mode_);
+        }
+        if ((mode->devices_) == (scenario.devices_.empty())) {
+            exitPlanError(plan_file_path_, line_list[idx],
+                          "Key devices is required by modes bidir, concurrent_* and fan_* only");
+        }
+        vector<std::string> args;
+        if (mode->option_[0] != '\0') {
+            args.push_back(mode->option_);
+        }
+        if (mode->devices_) {
+            args.push_back(scenario.devices_);
+        }
+        scenario.args_.insert(scenario.args_.begin(), args.begin(), args.end());
+    }
+
+    // Scenarios that specify no iterations run as many as user requested
+    plan_iter_cnt_ = num_iteration_;
+}
+
+void RocmBandwidthTest::LoadDefaultPlan() {
+    const char* options[] = {"-a", "-A"};
+    for (uint32_t idx = 0; idx < 2; idx++) {
+        plan_scenario_t scenario;
+        scenario.name_ = options[idx];
+        scenario.args_.push_back(options[idx]);
+        plan_list_.push_back(scenario);
+    }
+    plan_iter_cnt_ = num_iteration_;
+}
+
+bool RocmBandwidthTest::PlanCopiesAllDevices() const {
+    uint32_t plan_size = plan_list_.size();
+    for (uint32_t idx = 0; idx < plan_size; idx++) {
+        const vector<std::string>& args = plan_list_[idx].args_;
+        if ((std::find(args.begin(), args.end(), "-a") != args.end()) ||
+            (std::find(args.begin(), args.end(), "-A") != args.end())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RocmBandwidthTest::ResetScenario() {
+    req_read_ = REQ_INVALID;
+    req_write_ = REQ_INVALID;
+    req_version_ = REQ_INVALID;
+    req_topology_ = REQ_INVALID;
+    req_list_devs_ = REQ_INVALID;
+    req_copy_bidir_ = REQ_INVALID;
+    req_copy_unidir_ = REQ_INVALID;
+    req_copy_all_bidir_ = REQ_INVALID;
+    req_copy_all_unidir_ = REQ_INVALID;
+    req_concurrent_copy_bidir_ = REQ_INVALID;
+    req_concurrent_copy_unidir_ = REQ_INVALID;
+    fan_mode_ = FAN_NONE;
+
+    src_list_.clear();
+    dst_list_.clear();
+    bidir_list_.clear();
+    fan_list_.clear();
+    read_list_.clear();
+    write_list_.clear();
+    size_list_.clear();
+    trans_list_.clear();
+    if (active_agents_list_ != NULL) {
+        std::fill(active_agents_list_, active_agents_list_ + agent_index_, 0);
+    }
+
+    init_ = false;
+    latency_ = false;
+    numa_ = false;
+    health_ = false;
+    adaptive_ = false;
+    validate_ = false;
+    print_stats_ = false;
+    print_cpu_time_ = false;
+    collect_stats_ = false;
+    init_val_ = 11.231926;
+    sample_file_path_.clear();
+    json_file_path_.clear();
+    graph_file_path_.clear();
+    baseline_save_path_.clear();
+    baseline_cmp_path_.clear();
+    trace_file_path_.clear();
+    set_num_iteration(plan_iter_cnt_);
+
+    // Host buffers hold pattern of previous scenario and may be
+    // smaller than buffers of this one. Copy buffers and signals
+    // are kept only while a scenario runs, so idle ones do not
+    // hold memory of pools this scenario may never copy into
+    ReleaseStagingBufs();
+    FreeSessionResources();
+}
+
+void RocmBandwidthTest::SetUpScenario(const plan_scenario_t& scenario) {
+    ResetScenario();
+
+    // Options of scenario are parsed as if user passed them, so
+    // they are also reported as its launch command
+    char* prog_name = usr_argv_[0];
+    plan_argv_.clear();
+    plan_argv_.push_back(prog_name);
+    uint32_t arg_cnt = scenario.args_.size();
+    for (uint32_t idx = 0; idx < arg_cnt; idx++) {
+        plan_argv_.push_back(const_cast<char*>(scenario.args_[idx].c_str()));
+    }
+    plan_argv_.push_back(NULL);
+    usr_argc_ = plan_argv_.size() - 1;
+    usr_argv_ = &plan_argv_[0];
+    optind = 1;
+
+    uint32_t copy_mask = 0;
+    uint32_t copy_ctrl_mask = 0;
+    uint32_t num_primary_flags = 0;
+    bool status = ParseOptions(num_primary_flags, copy_mask, copy_ctrl_mask);
+    if (status) {
+        status = ValidateInputFlags(num_primary_flags, copy_mask, copy_ctrl_mask);
+    }
+    if (status == false) {
+        std::cout << "Keys of scenario " << scenario.name_ << " are illegal or can't be combined"
+                  << std::endl;
+        exit_test(1);
+    }
+    CheckOptions();
+
+    // Iterations of scenario take precedence over those of health check
+    if (scenario.iter_cnt_ != 0) {
+        set_num_iteration(scenario.iter_cnt_);
+    }
+
+    BuildRequestLists();
+    if ((ValidateArguments() == false) || (BuildTransList() == false)) {
+        std::cout << "Devices of scenario " << scenario.name_ << " are invalid" << std::endl;
+        exit_test(1);
+    }
+}
+
+void RocmBandwidthTest::RunPlan() {
+    uint32_t plan_size = plan_list_.size();
+    for (plan_index_ = 0; plan_index_ < plan_size; plan_index_++) {
+        const plan_scenario_t& scenario = plan_list_[plan_index_];
+        SetUpScenario(scenario);
+        if (plan_file_path_.empty() == false) {
+            std::cout << std::endl;
+            std::cout << "  Scenario " << (plan_index_ + 1) << " of " << plan_size << ": "
+                      << scenario.name_ << std::endl;
+        }
+        RunScenario();
+
+        // Default run displays version ahead of its first scenario only
+        if ((bw_default_run_ != NULL) && (plan_index_ != 0)) {
+            std::cout << std::endl;
+        }
+        Display();
+    }
+}
@@ -59,6 +59,21 @@ void RocmBandwidthTest::PrintHelpScreen() {
     std::cout << "\t -v    Run the test in validation mode" << std::endl;
     std::cout << "\t -l    Run test to collect Latency data" << std::endl;
     std::cout << "\t -c    Time the operation using CPU Timers" << std::endl;
+    std::cout << "\t -p    Print percentiles, deviation and histogram of copy times"
+              << std::endl;
+    std::cout << "\t -S    Sweep buffer sizes adaptively to locate the bandwidth knee"
+              << std::endl;
+    std::cout << "\t -R    Export copy time of every iteration into specified file"
+              << std::endl;
+    std::cout << "\t -j    Write results in JSON format into specified file" << std::endl;
+    std::cout << "\t -G    Write topology as a DOT or GraphML (.graphml) graph into specified file"
+              << std::endl;
+    std::cout << "\t -P    Write results in Prometheus format into specified directory"
+              << std::endl;
+    std::cout << "\t -B    Save results as baseline into specified file" << std::endl;
+    std::cout << "\t -C    Compare results with baseline read from specified file" << std::endl;
+    std::cout << "\t -D    Run copy requests periodically as a link monitoring daemon"
+              << std::endl;
     std::cout << "\t -e    Prints the list of ROCm devices enabled on platform" << std::endl;
     std::cout << "\t -i    Initialize copy buffer with specified 'long double' pattern"
               << std::endl;
@@ -69,6 +84,20 @@ void RocmBandwidthTest::PrintHelpScreen() {
               << std::endl;
     std::cout << "\t -d    List of destination devices to use in unidirectional copy operations"
               << std::endl;
+    std::cout << "\t -H    Check health of links by grading copies against expected bandwidth"
+              << std::endl;
+    std::cout << "\t -N    Compare copies with host buffers on nearest and farthest NUMA nodes"
+              << std::endl;
+    std::cout << "\t -F    Copy from first device of list to the others, or every Gpu, at once"
+              << std::endl;
+    std::cout << "\t -I    Copy into first device of list from the others, or every Gpu, at once"
+              << std::endl;
+    std::cout << "\t -n    Print planned copies, memory they need and estimated runtime"
+              << std::endl;
+    std::cout << "\t -f    Run scenarios listed in specified plan file in one process"
+              << std::endl;
+    std::cout << "\t -T    Replay transfers of specified trace file and report use of links"
+              << std::endl;
     std::cout << "\t -a    Perform Unidirectional Copy involving all device combinations"
               << std::endl;
     std::cout << "\t -A    Perform Bidirectional Copy involving all device combinations"
@@ -76,10 +105,11 @@ void RocmBandwidthTest::PrintHelpScreen() {
     std::cout << std::endl;
 
     std::cout << "\t NOTE: Mixing following options is illegal/unsupported" << std::endl;
-    std::cout << "\t\t Case 1: rocm_bandwidth_test -a with {lm}{1,}" << std::endl;
-    std::cout << "\t\t Case 2: rocm_bandwidth_test -b with {clv}{1,}" << std::endl;
-    std::cout << "\t\t Case 3: rocm_bandwidth_test -A with {clmv}{1,}" << std::endl;
-    std::cout << "\t\t Case 4: rocm_bandwidth_test -s x -d y with {lmv}{2,}" << std::endl;
+    std::cout << "\t\t Case 1: rocm_bandwidth_test -a, -H or -N with {lmS}{1,}" << std::endl;
+    std::cout << "\t\t Case 2: rocm_bandwidth_test -b with {clv}{1,} or {mS}{2,}" << std::endl;
+    std::cout << "\t\t Case 3: rocm_bandwidth_test -A with {clmvS}{1,}" << std::endl;
+    std::cout << "\t\t Case 4: rocm_bandwidth_test -s x -d y with {lmv}{2,} or {S}{lmv}{1,}"
+              << std::endl;
     std::cout << std::endl;
 
     std::cout << std::endl;
@@ -115,6 +145,28 @@ void RocmBandwidthTest::PrintLaunchCmd() const {
     std::cout << std::endl;
 }
 
+// @brief: Print time taken by each phase of topology discovery
+void RocmBandwidthTest::PrintDiscoveryTime() const {
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Topology discovery time (ms), " << discovery_threads_ << " threads" << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    uint32_t count = discovery_phases_.size();
+    for (uint32_t idx = 0; idx < count; idx++) {
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << discovery_phases_[idx].name_;
+        std::cout << discovery_phases_[idx].time_ms_ << std::endl;
+    }
+    std::cout << std::endl;
+}
+
 // @brief: Print the version of the test
 void RocmBandwidthTest::PrintVersion() const {
     uint32_t format = 10;
@@ -125,6 +177,13 @@ void RocmBandwidthTest::PrintVersion() const {
     std::cout << "";
     std::cout << "RocmBandwidthTest Version: " << GetVersion() << std::endl;
 
+    // Results of a simulated transport are not those of hardware
+    if (bw_sim_config_ != NULL) {
+        std::cout.width(format);
+        std::cout << "";
+        std::cout << "Simulated Transport Config: " << bw_sim_config_ << std::endl;
+    }
+
     // Print launch command
     PrintLaunchCmd();
 }
@@ -267,16 +326,16 @@ void RocmBandwidthTest::PrintLinkPropsMatrix(uint32_t key) const {
             uint32_t value = 0x00;
             switch (key) {
                 case LINK_PROP_ACCESS:
-                    value = direct_access_matrix_[(src_idx * agent_index_) + dst_idx];
+                    value = GetLinkProp(LINK_PROP_ACCESS, src_idx, dst_idx);
                     break;
                 case LINK_PROP_TYPE:
-                    value = link_type_matrix_[(src_idx * agent_index_) + dst_idx];
+                    value = GetLinkProp(LINK_PROP_TYPE, src_idx, dst_idx);
                     break;
                 case LINK_PROP_HOPS:
-                    value = link_hops_matrix_[(src_idx * agent_index_) + dst_idx];
+                    value = GetLinkProp(LINK_PROP_HOPS, src_idx, dst_idx);
                     break;
                 case LINK_PROP_WEIGHT:
-                    value = link_weight_matrix_[(src_idx * agent_index_) + dst_idx];
+                    value = GetLinkProp(LINK_PROP_WEIGHT, src_idx, dst_idx);
                     break;
             }
             std::cout.width(format);
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Name of file written into textfile collector directory
+#define PROM_FILE_NAME "rocm_bandwidth_test.prom"
+
+// @brief: Escape a label value as required by exposition format
+static std::string getPromLabelValue(const char* value) {
+    std::string label;
+    for (const char* ch = value; *ch != '\0'; ch++) {
+        if ((*ch == '\\') || (*ch == '"')) {
+            label += '\\';
+            label += *ch;
+        } else if (*ch == '\n') {
+            label += "\\n";
+        } else {
+            label += *ch;
+        }
+    }
+    return label;
+}
+
+void RocmBandwidthTest::WritePrometheusLabels(std::ostream& out, const async_trans_t& trans,
+                                              size_t size) const {
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    uint32_t dev_idx[] = {src_dev_idx, dst_dev_idx};
+    const char* prefix[] = {"src", "dst"};
+
+    // Uuid and Bdf are available only for Gpu agents
+    out << "{";
+    for (uint32_t idx = 0; idx < 2; idx++) {
+        const agent_info_t& agent = agent_list_[dev_idx[idx]];
+        bool gpu = (agent.device_type_ == HSA_DEVICE_TYPE_GPU);
+        out << prefix[idx] << "_agent=\"" << agent.index_ << "\",";
+        out << prefix[idx] << "_type=\"" << ((gpu) ? "GPU" : "CPU") << "\",";
+        out << prefix[idx] << "_uuid=\"" << ((gpu) ? getPromLabelValue(agent.uuid_) : "")
+            << "\",";
+        out << prefix[idx] << "_bdf=\"" << ((gpu) ? getPromLabelValue(agent.bdf_id_) : "")
+            << "\",";
+    }
+
+    uint32_t link_type = GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx);
+    uint32_t hops = GetLinkProp(LINK_PROP_HOPS, src_dev_idx, dst_dev_idx);
+    const char* link_str = "none";
+    if (link_type == LINK_TYPE_XGMI) {
+        link_str = "xGMI";
+    } else if (link_type == LINK_TYPE_PCIE) {
+        link_str = "PCIe";
+    } else if (link_type == LINK_TYPE_SELF) {
+        link_str = "self";
+    }
+    out << "link_type=\"" << link_str << "\",";
+    out << "hops=\"";
+    if (hops == 0xFFFFFFFF) {
+        out << "N/A";
+    } else {
+        out << hops;
+    }
+    out << "\",";
+    out << "direction=\"" << ((trans.copy.bidir_) ? "bidir" : "unidir") << "\",";
+    out << "size=\"" << size << "\"}";
+}
+
+void RocmBandwidthTest::WritePrometheusReport() const {
+    if (prom_dir_path_.empty()) {
+        return;
+    }
+
+    // Collect copy transactions whose results are reported
+    vector<const async_trans_t*> trans_list;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ != REQ_READ) && (trans.req_type_ != REQ_WRITE)) {
+            trans_list.push_back(&trans);
+        }
+    }
+
+    // Metrics are grouped by name as required by exposition format.
+    // Copies that failed validation are not reported
+    const char* names[] = {"peak_bandwidth_gbps", "avg_bandwidth_gbps", "min_copy_time_seconds",
+                           "avg_copy_time_seconds"};
+    const char* helps[] = {"Peak bandwidth of copy in GB/s", "Average bandwidth of copy in GB/s",
+                           "Minimum time taken by copy in seconds",
+                           "Average time taken by copy in seconds"};
+    std::stringstream out;
+    out.precision(9);
+    for (uint32_t metric = 0; metric < 4; metric++) {
+        out << "# HELP rocm_bandwidth_test_" << names[metric] << " " << helps[metric] << "\n";
+        out << "# TYPE rocm_bandwidth_test_" << names[metric] << " gauge\n";
+        for (uint32_t idx = 0; idx < trans_list.size(); idx++) {
+            const async_trans_t& trans = *trans_list[idx];
+            uint32_t size_len = trans.size_list_.size();
+            for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+                if (trans.min_time_[jdx] == VALIDATE_COPY_OP_FAILURE) {
+                    continue;
+                }
+                const vector<double>* values[] = {&trans.peak_bandwidth_, &trans.avg_bandwidth_,
+                                                  &trans.min_time_, &trans.avg_time_};
+                out << "rocm_bandwidth_test_" << names[metric];
+                WritePrometheusLabels(out, trans, trans.size_list_[jdx]);
+                out << " " << (*values[metric])[jdx] << "\n";
+            }
+        }
+    }
+    out << "# HELP rocm_bandwidth_test_last_run_timestamp_seconds Time results were collected\n";
+    out << "# TYPE rocm_bandwidth_test_last_run_timestamp_seconds gauge\n";
+    out << "rocm_bandwidth_test_last_run_timestamp_seconds " << (uint64_t)time(NULL) << "\n";
+
+    // Write into a temporary file of the same directory and rename
+    // it, which replaces the file seen by collector atomically.
+    // Collector ignores the temporary file as it lacks .prom suffix
+    std::string path = prom_dir_path_ + "/" + PROM_FILE_NAME;
+    std::stringstream tmp_path;
+    tmp_path << path << "." << getpid() << ".tmp";
+    std::ofstream file(tmp_path.str().c_str());
+    file << out.str();
+    file.close();
+    if ((file.fail()) || (rename(tmp_path.str().c_str(), path.c_str()) != 0)) {
+        std::cout << "Failed to write Prometheus file: " << path << std::endl;
+        unlink(tmp_path.str().c_str());
+        exit_test(1);
+    }
+}
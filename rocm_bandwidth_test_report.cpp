@@ -47,22 +47,25 @@
 #include <iomanip>
 #include <sstream>
 
-static void printRecord(size_t size, double avg_time, double avg_bandwidth, double min_time,
-                        double peak_bandwidth) {
+static std::string getSizeString(size_t size) {
     std::stringstream size_str;
-    if (size < 1024) {
+    if ((size < 1024) || (size % 1024)) {
         size_str << size << " Bytes";
-    } else if (size < 1024 * 1024) {
+    } else if ((size < 1024 * 1024) || (size % (1024 * 1024))) {
         size_str << size / 1024 << " KB";
     } else {
         size_str << size / (1024 * 1024) << " MB";
     }
+    return size_str.str();
+}
 
+static void printRecord(size_t size, double avg_time, double avg_bandwidth, double min_time,
+                        double peak_bandwidth) {
     uint32_t format = 15;
     std::cout.precision(3);
     std::cout << std::fixed;
     std::cout.width(format);
-    std::cout << size_str.str();
+    std::cout << getSizeString(size);
     std::cout.width(format);
     std::cout << (avg_time * 1e6);
     std::cout.width(format);
@@ -117,31 +120,59 @@ static void printCopyBanner(uint32_t src_pool_id, uint32_t src_agent_type, uint3
     std::cout << std::endl;
 }
 
-double RocmBandwidthTest::GetMinTime(std::vector<double>& vec) {
-    std::sort(vec.begin(), vec.end());
-    return vec.at(0);
-}
+double RocmBandwidthTest::GetMinTime(const SampleAccumulator& accum) { return accum.Min(); }
 
-double RocmBandwidthTest::GetMeanTime(std::vector<double>& vec) {
-    // In validation mode we run only one iteration
-    if (validate_) {
-        return vec.at(0);
+void RocmBandwidthTest::GetTimeStats(const SampleAccumulator& accum,
+                                     const std::vector<double>& raw_time,
+                                     stats_summary_t& stats) {
+    // Accumulator summarizes copy times in constant memory
+    if (raw_samples_ == false) {
+        accum.Summarize(stats);
+        return;
     }
 
     // Number of elements is ONE plus number of iterations
-    std::sort(vec.begin(), vec.end());
-    vec.erase(vec.end() - 1);
+    // The first one is dropped as it warms up the copy path
+    std::vector<double> samples(raw_time);
+    if (samples.size() > 1) {
+        samples.erase(samples.begin());
+    }
+    ComputeStats(samples, stats);
+}
 
-    double mean = 0.0;
-    int num = vec.size();
-    for (int it = 0; it < num; it++) {
-        mean += vec[it];
+double RocmBandwidthTest::GetMeanTime(const SampleAccumulator& accum) {
+    // In validation mode we run only one iteration
+    if ((validate_) || (accum.Count() < 2)) {
+        return accum.Min();
     }
-    mean /= num;
-    return mean;
+
+    // Number of samples is ONE plus number of iterations
+    // Drop the largest one which is usually the warm up
+    return (accum.Sum() - accum.Max()) / (accum.Count() - 1);
 }
 
 void RocmBandwidthTest::Display() const {
+    // Scenarios of a plan are displayed as each of them completes
+    if ((plan_list_.empty() == false) && (plan_index_ == plan_list_.size())) {
+        return;
+    }
+
+    // Dry run has no results to display
+    if (dry_run_) {
+        return;
+    }
+
+    // Replay of trace has results of its own
+    if (trace_list_.empty() == false) {
+        DisplayTrace();
+        return;
+    }
+
+    // Results are written in JSON, Prometheus and graph formats alongside the text
+    WriteJsonReport();
+    WritePrometheusReport();
+    WriteGraphReport();
+
     // Iterate through list of transactions and display its timing data
     uint32_t trans_size = trans_list_.size();
     if (trans_size == 0) {
@@ -159,12 +190,36 @@ void RocmBandwidthTest::Display() const {
         return;
     }
 
+    if (numa_) {
+        PrintVersion();
+        DisplayDevInfo();
+        PrintLinkPropsMatrix(LINK_PROP_WEIGHT);
+        DisplayNumaMatrix();
+        DisplayCopyStatsList();
+        DisplayBaselineDiff();
+        return;
+    }
+
+    if (health_) {
+        PrintVersion();
+        DisplayDevInfo();
+        PrintLinkPropsMatrix(LINK_PROP_TYPE);
+        DisplayCopyTimeMatrix(true);
+        DisplayPcieLinkInfo();
+        DisplayHealthMatrix();
+        return;
+    }
+
     if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
         PrintVersion();
         DisplayDevInfo();
         PrintLinkPropsMatrix(LINK_PROP_ACCESS);
         PrintLinkPropsMatrix(LINK_PROP_WEIGHT);
         DisplayCopyTimeMatrix(true);
+        DisplayPcieLinkInfo();
+        DisplayPcieEfficiency();
+        DisplayCopyStatsList();
+        DisplayBaselineDiff();
         return;
     }
 
@@ -176,6 +231,12 @@ void RocmBandwidthTest::Display() const {
             PrintLinkPropsMatrix(LINK_PROP_WEIGHT);
         }
         DisplayCopyTimeMatrix(true);
+        if (bw_default_run_ == NULL) {
+            DisplayPcieLinkInfo();
+        }
+        DisplayPcieEfficiency();
+        DisplayCopyStatsList();
+        DisplayBaselineDiff();
         return;
     }
 
@@ -196,7 +257,9 @@ void RocmBandwidthTest::Display() const {
             DisplayIOTime(trans);
         }
     }
+    DisplayFanTime();
     std::cout << std::endl;
+    DisplayBaselineDiff();
 }
 
 void RocmBandwidthTest::DisplayIOTime(async_trans_t& trans) const {}
@@ -214,11 +277,181 @@ void RocmBandwidthTest::DisplayCopyTime(async_trans_t& trans) const {
         ((trans.req_type_ == REQ_COPY_UNIDIR) || (trans.req_type_ == REQ_CONCURRENT_COPY_UNIDIR));
     printCopyBanner(src_idx, src_dev_type, dst_idx, dst_dev_type, unidir);
 
-    uint32_t size_len = size_list_.size();
+    uint32_t size_len = trans.size_list_.size();
     for (uint32_t idx = 0; idx < size_len; idx++) {
-        printRecord(size_list_[idx], trans.avg_time_[idx], trans.avg_bandwidth_[idx],
+        printRecord(trans.size_list_[idx], trans.avg_time_[idx], trans.avg_bandwidth_[idx],
                     trans.min_time_[idx], trans.peak_bandwidth_[idx]);
     }
+
+    // Print the knee located by an adaptive sweep
+    if (trans.knee_size_ != 0) {
+        uint32_t percent = (uint32_t)(knee_fraction_ * 100 + 0.5);
+        std::cout << std::endl;
+        std::cout << "Bandwidth reaches " << percent << "% of peak at ";
+        std::cout << getSizeString(trans.knee_size_) << " (" << trans.knee_bandwidth_ << " GB/s)";
+        std::cout << std::endl;
+    }
+
+    DisplayCopyStats(trans);
+}
+
+void RocmBandwidthTest::DisplayFanTime() const {
+    if (fan_mode_ == FAN_NONE) {
+        return;
+    }
+
+    // Print Aggregate Header
+    uint32_t trans_size = trans_list_.size();
+    uint32_t hub_idx = fan_list_[0];
+    uint32_t hub_dev_idx = pool_list_[hub_idx].agent_index_;
+    hsa_device_type_t hub_dev_type = agent_list_[hub_dev_idx].device_type_;
+    std::cout << std::endl;
+    std::cout << "================";
+    if (fan_mode_ == FAN_OUT) {
+        std::cout << "    Fan-out Aggregate Result";
+    } else {
+        std::cout << "    Fan-in Aggregate Result";
+    }
+    std::cout << "    ================";
+    std::cout << std::endl;
+    std::cout << "================";
+    std::cout << ((fan_mode_ == FAN_OUT) ? " Src Device Id: " : " Dst Device Id: ") << hub_idx;
+    std::cout << ((hub_dev_type == HSA_DEVICE_TYPE_CPU) ? " Type: Cpu" : " Type: Gpu");
+    std::cout << " Copies: " << trans_size;
+    std::cout << " ================";
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    uint32_t format = 15;
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "Data Size";
+    std::cout.width(format);
+    std::cout << "Avg Time(us)";
+    std::cout.width(format);
+    std::cout << "Avg BW(GB/s)";
+    std::cout.width(format);
+    std::cout << "Min Time(us)";
+    std::cout.width(format);
+    std::cout << "Peak BW(GB/s)";
+    std::cout << std::endl;
+
+    // Copies start together, so the group takes as long as
+    // its slowest copy and moves the data of all of them
+    uint32_t size_len = trans_list_[0].size_list_.size();
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        double avg_time = 0;
+        double min_time = 0;
+        for (uint32_t tidx = 0; tidx < trans_size; tidx++) {
+            avg_time = std::max(avg_time, trans_list_[tidx].avg_time_[idx]);
+            min_time = std::max(min_time, trans_list_[tidx].min_time_[idx]);
+        }
+        size_t size = trans_list_[0].size_list_[idx];
+        double data_size = (double)size * trans_size / (1000 * 1000 * 1000);
+        double avg_bandwidth = (avg_time > 0) ? (data_size / avg_time) : 0;
+        double peak_bandwidth = (min_time > 0) ? (data_size / min_time) : 0;
+        printRecord(size, avg_time, avg_bandwidth, min_time, peak_bandwidth);
+    }
+}
+
+void RocmBandwidthTest::DisplayCopyStats(const async_trans_t& trans) const {
+    if (print_stats_ == false) {
+        return;
+    }
+
+    uint32_t format = 12;
+    std::cout << std::endl;
+    std::cout.setf(ios::left);
+    std::cout.width(15);
+    std::cout << "Data Size";
+    const char* titles[] = {"Median(us)", "P90(us)",    "P99(us)", "P99.9(us)",
+                            "Max(us)",    "StdDev(us)", "CV(%)",   "Mean 95% CI(us)"};
+    for (uint32_t idx = 0; idx < (sizeof(titles) / sizeof(titles[0])); idx++) {
+        std::cout.width(format);
+        std::cout << titles[idx];
+    }
+    std::cout << std::endl;
+
+    // Print one row of statistics per size, skip sizes that
+    // failed validation as they have no samples
+    uint32_t size_len = trans.stats_.size();
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        const stats_summary_t& stats = trans.stats_[idx];
+        if (stats.count_ == 0) {
+            continue;
+        }
+        std::stringstream ci_str;
+        ci_str.precision(3);
+        ci_str << std::fixed << (stats.ci_low_ * 1e6) << "-" << (stats.ci_high_ * 1e6);
+
+        std::cout.precision(3);
+        std::cout << std::fixed;
+        std::cout.width(15);
+        std::cout << getSizeString(trans.size_list_[idx]);
+        double values[] = {stats.median_, stats.p90_, stats.p99_, stats.p999_,
+                           stats.max_,    stats.std_dev_};
+        for (uint32_t jdx = 0; jdx < (sizeof(values) / sizeof(values[0])); jdx++) {
+            std::cout.width(format);
+            std::cout << (values[jdx] * 1e6);
+        }
+        std::cout.width(format);
+        std::cout << (stats.coeff_var_ * 100);
+        std::cout << ci_str.str();
+        std::cout << std::endl;
+    }
+
+    // Print the histogram of each size, bars are scaled
+    // to the most populated bucket of the histogram
+    const uint32_t bar_width = 40;
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        const stats_summary_t& stats = trans.stats_[idx];
+        if (stats.count_ == 0) {
+            continue;
+        }
+        std::cout << std::endl;
+        std::cout << "Histogram of copy times for " << getSizeString(trans.size_list_[idx]);
+        std::cout << ", " << stats.count_ << " samples" << std::endl;
+
+        uint64_t max_count = *std::max_element(stats.hist_.begin(), stats.hist_.end());
+        uint32_t bucket_cnt = stats.hist_.size();
+        for (uint32_t jdx = 0; jdx < bucket_cnt; jdx++) {
+            int32_t bucket = stats.hist_base_ + jdx;
+            double low = GetHistBucketBound(bucket) * stats.hist_scale_ * 1e6;
+            double high = GetHistBucketBound(bucket + 1) * stats.hist_scale_ * 1e6;
+            std::stringstream range_str;
+            range_str.precision(3);
+            range_str << std::fixed << "[" << low << ", " << high << ") us";
+
+            uint64_t count = stats.hist_[jdx];
+            uint32_t bar_len = (uint32_t)((count * bar_width) / max_count);
+            std::cout << "    ";
+            std::cout.width(32);
+            std::cout << range_str.str();
+            std::cout.width(bar_width + 2);
+            std::cout << std::string(bar_len, '#');
+            std::cout << count << std::endl;
+        }
+    }
+}
+
+void RocmBandwidthTest::DisplayCopyStatsList() const {
+    if (print_stats_ == false) {
+        return;
+    }
+
+    // Print statistics of each transaction under a short banner
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        std::cout << std::endl;
+        std::cout << "================ Copy time statistics: Src Device " << src_dev_idx;
+        std::cout << ((trans.copy.bidir_) ? " <-> " : " -> ");
+        std::cout << "Dst Device " << dst_dev_idx << " ================" << std::endl;
+        DisplayCopyStats(trans);
+    }
+    std::cout << std::endl;
 }
 
 void RocmBandwidthTest::PopulatePerfMatrix(bool peak, double* perf_matrix) const {
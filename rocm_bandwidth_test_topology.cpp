@@ -43,20 +43,23 @@
 #include "common.hpp"
 #include "rocm_bandwidth_test.hpp"
 
+#include <chrono>
 #include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <thread>
 
 // @brief: Helper method to iterate throught the memory pools of
 // an agent and discover its properties
 hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
     hsa_status_t status;
     RocmBandwidthTest* asyncDrvr = reinterpret_cast<RocmBandwidthTest*>(data);
+    Transport* transport = asyncDrvr->transport_;
 
     // Query pools' segment, report only pools from global segment
     hsa_amd_segment_t segment;
-    status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_SEGMENT, &segment);
+    status = transport->GetPoolInfo(pool, HSA_AMD_MEMORY_POOL_INFO_SEGMENT, &segment);
     ErrorCheck(status);
     if (HSA_AMD_SEGMENT_GLOBAL != segment) {
         return HSA_STATUS_SUCCESS;
@@ -65,8 +68,7 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
     // Determine if allocation is allowed in this pool
     // Report only pools that allow an alloction by user
     bool alloc = false;
-    status =
-        hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALLOWED, &alloc);
+    status = transport->GetPoolInfo(pool, HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALLOWED, &alloc);
     ErrorCheck(status);
     if (alloc != true) {
         return HSA_STATUS_SUCCESS;
@@ -74,32 +76,34 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
 
     // Query the max allocatable size
     size_t max_size = 0;
-    status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_SIZE, &max_size);
+    status = transport->GetPoolInfo(pool, HSA_AMD_MEMORY_POOL_INFO_SIZE, &max_size);
     ErrorCheck(status);
 
     // Determine if the pools is accessible to all agents
     bool access_to_all = false;
-    status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_ACCESSIBLE_BY_ALL,
-                                          &access_to_all);
+    status = transport->GetPoolInfo(pool, HSA_AMD_MEMORY_POOL_INFO_ACCESSIBLE_BY_ALL,
+                                    &access_to_all);
     ErrorCheck(status);
 
     // Determine type of access to owner agent
     hsa_amd_memory_pool_access_t owner_access;
     hsa_agent_t agent = asyncDrvr->agent_list_.back().agent_;
-    status = hsa_amd_agent_memory_pool_get_info(agent, pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS,
-                                                &owner_access);
+    status = transport->GetAgentPoolInfo(agent, pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS,
+                                         &owner_access);
     ErrorCheck(status);
 
     // Determine if the pool is fine-grained or coarse-grained
     uint32_t flag = 0;
-    status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_GLOBAL_FLAGS, &flag);
+    status = transport->GetPoolInfo(pool, HSA_AMD_MEMORY_POOL_INFO_GLOBAL_FLAGS, &flag);
     ErrorCheck(status);
     bool is_kernarg = (HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_KERNARG_INIT & flag);
     bool is_fine_grained = (HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_FINE_GRAINED & flag);
 
     // Update the pool handle for system memory if kernarg is true
-    if (is_kernarg) {
-        asyncDrvr->sys_pool_ = pool;
+    staging_buf_t& staging = asyncDrvr->staging_list_.back();
+    if ((is_kernarg) && (staging.valid_ == false)) {
+        staging.pool_ = pool;
+        staging.valid_ = true;
     }
 
     // Consult user request and add either fine-grained or
@@ -150,12 +154,12 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
 }
 
 void PopulateBDF(uint32_t bdf_id, agent_info_t* agent_info) {
-    uint8_t func_id = (bdf_id & 0x00000003);
+    uint8_t func_id = (bdf_id & 0x00000007);
     uint8_t dev_id = ((bdf_id & 0x000000F8) >> 3);
     uint8_t bus_id = ((bdf_id & 0x0000FF00) >> 8);
     std::stringstream stream;
-    stream << std::setfill('0') << std::setw(sizeof(uint8_t) * 2);
-    stream << std::hex << +bus_id << ":" << +dev_id << "." << +func_id;
+    stream << std::setfill('0') << std::hex;
+    stream << std::setw(2) << +bus_id << ":" << std::setw(2) << +dev_id << "." << +func_id;
     std::strcpy(agent_info->bdf_id_, (stream.str()).c_str());
 }
 
@@ -163,40 +167,50 @@ void PopulateBDF(uint32_t bdf_id, agent_info_t* agent_info) {
 // a system and discover its properties
 hsa_status_t AgentInfo(hsa_agent_t agent, void* data) {
     RocmBandwidthTest* asyncDrvr = reinterpret_cast<RocmBandwidthTest*>(data);
+    Transport* transport = asyncDrvr->transport_;
 
     // Get the name of the agent
     char agent_name[64];
     hsa_status_t status;
-    status = hsa_agent_get_info(agent, HSA_AGENT_INFO_NAME, agent_name);
+    status = transport->GetAgentInfo(agent, HSA_AGENT_INFO_NAME, agent_name);
     ErrorCheck(status);
 
     // Get device type
     hsa_device_type_t device_type;
-    status = hsa_agent_get_info(agent, HSA_AGENT_INFO_DEVICE, &device_type);
+    status = transport->GetAgentInfo(agent, HSA_AGENT_INFO_DEVICE, &device_type);
     ErrorCheck(status);
 
-    // Capture the handle of Cpu agent
-    if (device_type == HSA_DEVICE_TYPE_CPU) {
-        asyncDrvr->cpu_agent_ = agent;
-        asyncDrvr->cpu_index_ = asyncDrvr->agent_index_;
-    }
+    // Every Cpu agent stages buffers of devices nearest to it
+    // using its system pool, which is bound when pools are found
+    staging_buf_t staging;
+    staging.agent_ = agent;
+    asyncDrvr->staging_list_.push_back(staging);
 
     // Instantiate an instance of agent_info_t and populate its name
     // and BDF fields before adding it to the list of agent_info_t objects
     agent_info_t agent_info(agent, asyncDrvr->agent_index_, device_type);
-    status = hsa_agent_get_info(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_PRODUCT_NAME,
-                                (void*)&agent_info.name_[0]);
+    status = transport->GetAgentInfo(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_PRODUCT_NAME,
+                                     (void*)&agent_info.name_[0]);
+    status = transport->GetAgentInfo(agent, HSA_AGENT_INFO_NODE, &agent_info.node_id_);
+    ErrorCheck(status);
 
     // Aqcuire GPU specific properties
     //    - BDF (a 32-bit integer)
     //    - UUID (a 21 char string including nil)
+    //    - PCI domain (a 32-bit integer)
+    agent_info.domain_ = 0;
     if (device_type == HSA_DEVICE_TYPE_GPU) {
-        status =
-            hsa_agent_get_info(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_UUID, agent_info.uuid_);
+        status = transport->GetAgentInfo(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_UUID,
+                                         agent_info.uuid_);
         uint32_t bdf_id = 0;
-        status =
-            hsa_agent_get_info(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_BDFID, (void*)&bdf_id);
+        status = transport->GetAgentInfo(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_BDFID,
+                                         (void*)&bdf_id);
         PopulateBDF(bdf_id, &agent_info);
+        status = transport->GetAgentInfo(agent, (hsa_agent_info_t)HSA_AMD_AGENT_INFO_DOMAIN,
+                                         (void*)&agent_info.domain_);
+        if (status != HSA_STATUS_SUCCESS) {
+            agent_info.domain_ = 0;
+        }
     }
     asyncDrvr->agent_list_.push_back(agent_info);
 
@@ -205,66 +219,188 @@ hsa_status_t AgentInfo(hsa_agent_t agent, void* data) {
     node.agent = asyncDrvr->agent_list_.back();
     asyncDrvr->agent_pool_list_.push_back(node);
 
-    status = hsa_amd_agent_iterate_memory_pools(agent, MemPoolInfo, asyncDrvr);
+    status = transport->IteratePools(agent, MemPoolInfo, asyncDrvr);
     asyncDrvr->agent_index_++;
 
     return HSA_STATUS_SUCCESS;
 }
 
 void RocmBandwidthTest::PopulateAccessMatrix() {
-    // Allocate memory to hold access lists
-    access_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-    direct_access_matrix_ = new uint32_t[agent_index_ * agent_index_]();
+    RunDiscoveryThreads(&RocmBandwidthTest::PopulateAccessRows);
+}
 
+void RocmBandwidthTest::PopulateAccessRows(uint32_t first, uint32_t stride) {
+    for (uint32_t src_dev_idx = first; src_dev_idx < agent_index_; src_dev_idx += stride) {
+        for (uint32_t dst_dev_idx = 0; dst_dev_idx < agent_index_; dst_dev_idx++) {
+            PopulateAccessCell(src_dev_idx, dst_dev_idx);
+        }
+    }
+}
+
+void RocmBandwidthTest::PopulateAccessCell(uint32_t src_dev_idx, uint32_t dst_dev_idx) const {
+    // Pools are visited in order of discovery, so the last pair
+    // of pools of the two agents determines their access
     hsa_status_t status;
-    uint32_t size = pool_list_.size();
-    for (uint32_t src_idx = 0; src_idx < size; src_idx++) {
+    uint32_t cell = (src_dev_idx * agent_index_) + dst_dev_idx;
+    const vector<pool_info_t>& src_pools = agent_pool_list_[src_dev_idx].pool_list;
+    const vector<pool_info_t>& dst_pools = agent_pool_list_[dst_dev_idx].pool_list;
+    hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+    hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
+    for (uint32_t src_idx = 0; src_idx < src_pools.size(); src_idx++) {
         // Get handle of Src agent of the pool
-        uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-        hsa_agent_t src_agent = pool_list_[src_idx].owner_agent_;
-        hsa_amd_memory_pool_t src_pool = pool_list_[src_idx].pool_;
-        hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+        hsa_agent_t src_agent = src_pools[src_idx].owner_agent_;
+        hsa_amd_memory_pool_t src_pool = src_pools[src_idx].pool_;
 
-        for (uint32_t dst_idx = 0; dst_idx < size; dst_idx++) {
+        for (uint32_t dst_idx = 0; dst_idx < dst_pools.size(); dst_idx++) {
             // Get handle of Dst pool
-            uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-            hsa_agent_t dst_agent = pool_list_[dst_idx].owner_agent_;
-            hsa_amd_memory_pool_t dst_pool = pool_list_[dst_idx].pool_;
-            hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
+            hsa_agent_t dst_agent = dst_pools[dst_idx].owner_agent_;
+            hsa_amd_memory_pool_t dst_pool = dst_pools[dst_idx].pool_;
 
             // Determine if src agent has access to dst pool
             hsa_amd_memory_pool_access_t access;
-            status = hsa_amd_agent_memory_pool_get_info(
-                src_agent, dst_pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
+            status = transport_->GetAgentPoolInfo(src_agent, dst_pool,
+                                                  HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
             ErrorCheck(status);
 
             // Record if Src device can access or not
             uint32_t path;
             path = (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) ? 0 : 1;
-            direct_access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx] = path;
+            direct_access_matrix_[cell] = path;
 
             if ((src_dev_type == HSA_DEVICE_TYPE_CPU) && (dst_dev_type == HSA_DEVICE_TYPE_GPU) &&
                 (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED)) {
-                status = hsa_amd_agent_memory_pool_get_info(
-                    dst_agent, src_pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
+                status = transport_->GetAgentPoolInfo(dst_agent, src_pool,
+                                                      HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS,
+                                                      &access);
                 ErrorCheck(status);
             }
 
             // Access between the two agents is Non-Existent
             path = (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) ? 0 : 1;
-            access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx] = path;
+            access_matrix_[cell] = path;
+        }
+    }
+    access_known_[cell] = 1;
+}
+
+uint32_t RocmBandwidthTest::GetLinkProp(uint32_t key, uint32_t src_dev_idx,
+                                        uint32_t dst_dev_idx) const {
+    // Cells are discovered when first needed unless they were
+    // discovered eagerly for all agents or read from cache
+    uint32_t cell = (src_dev_idx * agent_index_) + dst_dev_idx;
+    if ((key == LINK_PROP_ACCESS) || (key == LINK_PROP_PATH)) {
+        if (access_known_[cell] == 0) {
+            PopulateAccessCell(src_dev_idx, dst_dev_idx);
+        }
+        return (key == LINK_PROP_ACCESS) ? direct_access_matrix_[cell] : access_matrix_[cell];
+    }
+
+    if (link_known_[cell] == 0) {
+        vector<hsa_amd_memory_pool_link_info_t> link_info;
+        BindLinkProps(src_dev_idx, dst_dev_idx, link_info);
+    }
+    switch (key) {
+        case LINK_PROP_TYPE:
+            return link_type_matrix_[cell];
+        case LINK_PROP_HOPS:
+            return link_hops_matrix_[cell];
+        default:
+            return link_weight_matrix_[cell];
+    }
+}
+
+void RocmBandwidthTest::RunDiscoveryThreads(void (RocmBandwidthTest::*rows)(uint32_t, uint32_t)) {
+    // Rows are dealt to threads round robin, so each thread writes
+    // only to rows it owns and no locking is needed
+    uint32_t count = std::min(discovery_threads_, agent_index_);
+    if (count <= 1) {
+        (this->*rows)(0, 1);
+        return;
+    }
+    vector<std::thread> threads;
+    vector<int32_t> exit_list(count, 0);
+    for (uint32_t idx = 0; idx < count; idx++) {
+        threads.push_back(std::thread(&RocmBandwidthTest::RunDiscoveryWorker, this, rows, idx,
+                                      count, &exit_list[idx]));
+    }
+    for (uint32_t idx = 0; idx < count; idx++) {
+        threads[idx].join();
+    }
+
+    // Errors are reported once every worker has stopped, by calling
+    // thread, which exits or unwinds as it is set to
+    for (uint32_t idx = 0; idx < count; idx++) {
+        if (exit_list[idx] != 0) {
+            exit_test(exit_list[idx]);
         }
     }
 }
 
+void RocmBandwidthTest::RunDiscoveryWorker(void (RocmBandwidthTest::*rows)(uint32_t, uint32_t),
+                                           uint32_t first, uint32_t stride, int32_t* exit_value) {
+    // An error must not exit process nor escape thread, so it is
+    // caught and handed back to the thread that started the worker
+    ExitUnwindScope unwind(true);
+    try {
+        (this->*rows)(first, stride);
+    } catch (const test_exit_t& test_exit) {
+        *exit_value = test_exit.value_;
+    }
+}
+
+void RocmBandwidthTest::RecordDiscoveryPhase(const char* name,
+                                             std::chrono::steady_clock::time_point& start) {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    discovery_phase_t phase;
+    phase.name_ = name;
+    phase.time_ms_ = std::chrono::duration<double, std::milli>(end - start).count();
+    discovery_phases_.push_back(phase);
+    start = end;
+}
+
 void RocmBandwidthTest::DiscoverTopology() {
     // Populate the lists of agents and pools
-    err_ = hsa_iterate_agents(AgentInfo, this);
-
-    // Populate the access, link type and weight matrices
-    // Access matrix must be populated first
-    PopulateAccessMatrix();
-    DiscoverLinkProps();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    err_ = transport_->IterateAgents(AgentInfo, this);
+    RecordDiscoveryPhase("agents", start);
+
+    // Allocate the access, link type and weight matrices
+    uint32_t cell_cnt = agent_index_ * agent_index_;
+    access_matrix_ = new uint32_t[cell_cnt]();
+    direct_access_matrix_ = new uint32_t[cell_cnt]();
+    link_type_matrix_ = new uint32_t[cell_cnt]();
+    link_hops_matrix_ = new uint32_t[cell_cnt]();
+    link_weight_matrix_ = new uint32_t[cell_cnt]();
+    access_known_ = new uint8_t[cell_cnt]();
+    link_known_ = new uint8_t[cell_cnt]();
+
+    // Matrices are read from cache if topology has not changed
+    // since. Runs that involve all agents or print the topology
+    // populate them eagerly, while others discover only cells
+    // they need when they first need them. Scenarios of a plan
+    // are not set up yet, so their options are looked up instead
+    uint64_t fingerprint = 0;
+    bool cached = false;
+    if (bw_topology_cache_ != NULL) {
+        fingerprint = GetTopologyFingerprint();
+        cached = LoadTopologyCache(fingerprint);
+        RecordDiscoveryPhase("cache", start);
+    }
+    bool eager = (bw_topology_cache_ != NULL) || (req_topology_ == REQ_TOPOLOGY) ||
+                 (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) ||
+                 (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) || (PlanCopiesAllDevices());
+    if ((cached == false) && (eager)) {
+        PopulateAccessMatrix();
+        RecordDiscoveryPhase("access", start);
+        DiscoverLinkProps();
+        RecordDiscoveryPhase("links", start);
+        if (bw_topology_cache_ != NULL) {
+            SaveTopologyCache(fingerprint);
+        }
+    }
+    DiscoverPcieLinks();
+    DiscoverNumaNodes();
+    RecordDiscoveryPhase("sysfs", start);
 }
 
 uint32_t GetLinkType(hsa_device_type_t src_dev_type, hsa_device_type_t dst_dev_type,
@@ -301,7 +437,17 @@ uint32_t GetLinkWeight(hsa_amd_memory_pool_link_info_t* link_info, uint32_t hops
     return weight;
 }
 
-void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) {
+void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2,
+                                      vector<hsa_amd_memory_pool_link_info_t>& link_info) const {
+    // Agent is bound to itself by a link of its own
+    link_known_[(idx1 * agent_index_) + idx2] = 1;
+    if (idx1 == idx2) {
+        link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0;
+        link_weight_matrix_[(idx1 * agent_index_) + idx2] = 0;
+        link_type_matrix_[(idx1 * agent_index_) + idx2] = LINK_TYPE_SELF;
+        return;
+    }
+
     // Agent has no pools so no need to look for numa distance
     if (agent_pool_list_[idx2].pool_list.size() == 0) {
         link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0xFFFFFFFF;
@@ -310,57 +456,48 @@ void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) {
         return;
     }
 
+    // Status is kept local as rows are bound by several threads
     uint32_t hops = 0;
+    hsa_status_t status;
     hsa_agent_t agent1 = agent_list_[idx1].agent_;
-    hsa_amd_memory_pool_t& pool = agent_pool_list_[idx2].pool_list[0].pool_;
-    err_ = hsa_amd_agent_memory_pool_get_info(agent1, pool,
-                                              HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS, &hops);
-    if (hops < 1) {
+    hsa_amd_memory_pool_t pool = agent_pool_list_[idx2].pool_list[0].pool_;
+    status = transport_->GetAgentPoolInfo(agent1, pool,
+                                          HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS, &hops);
+    if ((status != HSA_STATUS_SUCCESS) || (hops < 1)) {
         link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0xFFFFFFFF;
         link_weight_matrix_[(idx1 * agent_index_) + idx2] = 0xFFFFFFFF;
         link_type_matrix_[(idx1 * agent_index_) + idx2] = LINK_TYPE_NO_PATH;
         return;
     }
 
-    hsa_amd_memory_pool_link_info_t* link_info;
-    uint32_t link_info_sz = hops * sizeof(hsa_amd_memory_pool_link_info_t);
-    link_info = (hsa_amd_memory_pool_link_info_t*)malloc(link_info_sz);
-    std::memset(link_info, 0, (hops * sizeof(hsa_amd_memory_pool_link_info_t)));
-    err_ = hsa_amd_agent_memory_pool_get_info(agent1, pool,
-                                              HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO, link_info);
-
+    // Link info block is scratch of calling thread, grown as needed
+    if (link_info.size() < hops) {
+        link_info.resize(hops);
+    }
+    std::memset(&link_info[0], 0, (hops * sizeof(hsa_amd_memory_pool_link_info_t)));
+    status = transport_->GetAgentPoolInfo(agent1, pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO,
+                                          &link_info[0]);
 
     link_hops_matrix_[(idx1 * agent_index_) + idx2] = hops;
-    link_weight_matrix_[(idx1 * agent_index_) + idx2] = GetLinkWeight(link_info, hops);
+    link_weight_matrix_[(idx1 * agent_index_) + idx2] = GetLinkWeight(&link_info[0], hops);
 
     // Initialize link type based on Src and Dst devices plus link
     // type reported by ROCr library
     hsa_device_type_t src_dev_type = agent_list_[idx1].device_type_;
     hsa_device_type_t dst_dev_type = agent_list_[idx2].device_type_;
     link_type_matrix_[(idx1 * agent_index_) + idx2] =
-        GetLinkType(src_dev_type, dst_dev_type, link_info, hops);
-    // Free the allocated link block
-    free(link_info);
+        GetLinkType(src_dev_type, dst_dev_type, &link_info[0], hops);
 }
 
 void RocmBandwidthTest::DiscoverLinkProps() {
-    // Allocate space if it is first time
-    if (link_weight_matrix_ == NULL) {
-        link_type_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-        link_hops_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-        link_weight_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-    }
+    RunDiscoveryThreads(&RocmBandwidthTest::DiscoverLinkRows);
+}
 
-    agent_info_t agent_info;
-    for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
+void RocmBandwidthTest::DiscoverLinkRows(uint32_t first, uint32_t stride) {
+    vector<hsa_amd_memory_pool_link_info_t> link_info;
+    for (uint32_t idx1 = first; idx1 < agent_index_; idx1 += stride) {
         for (uint32_t idx2 = 0; idx2 < agent_index_; idx2++) {
-            if (idx1 == idx2) {
-                link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0;
-                link_weight_matrix_[(idx1 * agent_index_) + idx2] = 0;
-                link_type_matrix_[(idx1 * agent_index_) + idx2] = LINK_TYPE_SELF;
-                continue;
-            }
-            BindLinkProps(idx1, idx2);
+            BindLinkProps(idx1, idx2, link_info);
         }
     }
 }
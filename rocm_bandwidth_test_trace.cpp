@@ -0,0 +1,428 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Transfers of a trace that share a link, in one direction
+typedef struct trace_link {
+        trace_link() {
+            copy_cnt_ = 0;
+            bytes_ = 0;
+            busy_us_ = 0;
+        }
+
+        uint32_t copy_cnt_;
+        double bytes_;
+        double busy_us_;
+        vector<std::pair<uint64_t, uint64_t>> span_list_;
+} trace_link_t;
+
+static std::string trimTraceString(const std::string& str) {
+    const char* space = " \t\r\n";
+    size_t first = str.find_first_not_of(space);
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = str.find_last_not_of(space);
+    return str.substr(first, (last - first) + 1);
+}
+
+static void exitTraceError(const std::string& path, uint32_t line, const std::string& msg) {
+    std::cout << "Trace file " << path << ", line " << line << ": " << msg << std::endl;
+    exit_test(1);
+}
+
+// Parse value as a number that is not negative, returns
+// false if it is illegal
+static bool parseTraceNumber(const std::string& value, double& num) {
+    char* end = NULL;
+    num = strtod(value.c_str(), &end);
+    return ((end != value.c_str()) && (*end == '\0') && (num >= 0));
+}
+
+static bool parseTraceIndex(const std::string& value, uint32_t& num) {
+    char* end = NULL;
+    unsigned long index = strtoul(value.c_str(), &end, 10);
+    num = index;
+    return ((value.empty() == false) && (value[0] != '-') && (*end == '\0') &&
+            (index <= 0xFFFF));
+}
+
+void RocmBandwidthTest::LoadTrace() {
+    std::ifstream in(trace_file_path_.c_str());
+    if (in.is_open() == false) {
+        std::cout << "Unable to open trace file: " << trace_file_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Every transfer is a line of id, start, src, dst, size and an
+    // optional duration. Start is a time in microseconds since start
+    // of trace, or after:<id> to start when that transfer completes.
+    // Lines starting with # and a header line starting with id are
+    // skipped
+    std::string line;
+    uint32_t line_num = 0;
+    std::map<std::string, int32_t> id_map;
+    double last_start = 0;
+    bool first_line = true;
+    while (std::getline(in, line)) {
+        line_num++;
+        line = trimTraceString(line);
+        if ((line.empty()) || (line[0] == '#')) {
+            continue;
+        }
+
+        vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ',')) {
+            fields.push_back(trimTraceString(field));
+        }
+        if ((first_line) && (fields[0] == "id")) {
+            first_line = false;
+            continue;
+        }
+        first_line = false;
+        if ((fields.size() < 5) || (fields.size() > 6)) {
+            exitTraceError(trace_file_path_, line_num,
+                           "Expected id, start, src, dst, size and optional duration");
+        }
+
+        trace_xfer_t xfer;
+        xfer.id_ = fields[0];
+        if ((xfer.id_.empty()) || (id_map.find(xfer.id_) != id_map.end())) {
+            exitTraceError(trace_file_path_, line_num, "Id is empty or duplicated: " + xfer.id_);
+        }
+
+        // Transfers that start at a time are replayed in order of
+        // their lines, so their times must not decrease
+        if (fields[1].compare(0, 6, "after:") == 0) {
+            std::map<std::string, int32_t>::iterator it = id_map.find(fields[1].substr(6));
+            if (it == id_map.end()) {
+                exitTraceError(trace_file_path_, line_num,
+                               "Transfer must start after one of an earlier line: " + fields[1]);
+            }
+            xfer.after_ = it->second;
+        } else if ((parseTraceNumber(fields[1], xfer.start_us_) == false) ||
+                   (xfer.start_us_ < last_start)) {
+            exitTraceError(trace_file_path_, line_num,
+                           "Start is illegal or earlier than that of previous line: " + fields[1]);
+        } else {
+            last_start = xfer.start_us_;
+        }
+
+        double size = 0;
+        if ((parseTraceIndex(fields[2], xfer.src_idx_) == false) ||
+            (parseTraceIndex(fields[3], xfer.dst_idx_) == false) ||
+            (parseTraceNumber(fields[4], size) == false) || (size < 1) ||
+            ((fields.size() == 6) && (parseTraceNumber(fields[5], xfer.duration_us_) == false))) {
+            exitTraceError(trace_file_path_, line_num,
+                           "Illegal src, dst, size or duration: " + line);
+        }
+        xfer.size_ = (size_t)size;
+        id_map[xfer.id_] = trace_list_.size();
+        trace_list_.push_back(xfer);
+    }
+
+    if (trace_list_.empty()) {
+        std::cout << "Trace file has no transfers: " << trace_file_path_ << std::endl;
+        exit_test(1);
+    }
+}
+
+void RocmBandwidthTest::ValidateTrace() {
+    // Transfers are between pools that can be copied between, as
+    // copies of option -s and -d are
+    uint32_t pool_cnt = pool_list_.size();
+    uint32_t xfer_cnt = trace_list_.size();
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        const trace_xfer_t& xfer = trace_list_[idx];
+        if ((xfer.src_idx_ >= pool_cnt) || (xfer.dst_idx_ >= pool_cnt)) {
+            std::cout << "Transfer " << xfer.id_ << " of trace uses a pool that is not present: "
+                      << xfer.src_idx_ << ", " << xfer.dst_idx_ << std::endl;
+            exit_test(1);
+        }
+        uint32_t src_dev_idx = pool_list_[xfer.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[xfer.dst_idx_].agent_index_;
+        if ((agent_list_[src_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU) &&
+            (agent_list_[dst_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU)) {
+            std::cout << "Transfer " << xfer.id_ << " of trace is between Cpu pools" << std::endl;
+            exit_test(1);
+        }
+        if ((src_dev_idx != dst_dev_idx) &&
+            (GetLinkProp(LINK_PROP_PATH, src_dev_idx, dst_dev_idx) == 0)) {
+            std::cout << "Transfer " << xfer.id_ << " of trace has no path from pool "
+                      << xfer.src_idx_ << " to pool " << xfer.dst_idx_ << std::endl;
+            exit_test(1);
+        }
+
+        if (active_agents_list_ == NULL) {
+            active_agents_list_ = new uint32_t[agent_index_]();
+        }
+        active_agents_list_[src_dev_idx] = 1;
+        active_agents_list_[dst_dev_idx] = 1;
+    }
+}
+
+void RocmBandwidthTest::RunTrace() {
+    // Every pool holds one source and one destination buffer, each
+    // as large as the largest transfer that uses it. Transfers that
+    // overlap share them, as only their time is of interest
+    uint32_t pool_cnt = pool_list_.size();
+    uint32_t xfer_cnt = trace_list_.size();
+    vector<size_t> src_size(pool_cnt, 0);
+    vector<size_t> dst_size(pool_cnt, 0);
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        const trace_xfer_t& xfer = trace_list_[idx];
+        src_size[xfer.src_idx_] = std::max(src_size[xfer.src_idx_], xfer.size_);
+        dst_size[xfer.dst_idx_] = std::max(dst_size[xfer.dst_idx_], xfer.size_);
+    }
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        size_t budget = pool_list_[idx].allocable_size_ * pool_fraction_;
+        if ((src_size[idx] + dst_size[idx]) > budget) {
+            std::cout << "Transfers of trace need " << ((src_size[idx] + dst_size[idx]) >> 20)
+                      << " MB, which exceeds memory budget of pool " << idx << ": "
+                      << (budget >> 20) << " MB" << std::endl;
+            exit_test(1);
+        }
+    }
+
+    vector<void*> buf_list;
+    vector<void*> src_buf(pool_cnt, (void*)NULL);
+    vector<void*> dst_buf(pool_cnt, (void*)NULL);
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        if (src_size[idx] != 0) {
+            src_buf[idx] = AcquireBuffer(pool_list_[idx].pool_, src_size[idx]);
+            buf_list.push_back(src_buf[idx]);
+        }
+        if (dst_size[idx] != 0) {
+            dst_buf[idx] = AcquireBuffer(pool_list_[idx].pool_, dst_size[idx]);
+            buf_list.push_back(dst_buf[idx]);
+        }
+    }
+
+    // Grant access once per pair of pools, before replay begins
+    vector<hsa_signal_t> sig_list;
+    std::set<std::pair<uint32_t, uint32_t>> granted;
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        const trace_xfer_t& xfer = trace_list_[idx];
+        sig_list.push_back(AcquireSignal());
+        if (granted.insert(std::make_pair(xfer.src_idx_, xfer.dst_idx_)).second == false) {
+            continue;
+        }
+        const pool_info_t& src_pool = pool_list_[xfer.src_idx_];
+        const pool_info_t& dst_pool = pool_list_[xfer.dst_idx_];
+        AcquirePoolAcceses(src_pool.agent_index_, src_pool.owner_agent_, src_buf[xfer.src_idx_],
+                           dst_pool.agent_index_, dst_pool.owner_agent_, dst_buf[xfer.dst_idx_]);
+    }
+
+    err_ = transport_->EnableProfiling(true);
+    ErrorCheck(err_);
+
+    // Transfers are submitted in order of their lines. Those that
+    // start at a time are held until it comes, those that start
+    // after another depend upon its signal. Times are counted from
+    // first transfer, as traces may carry absolute timestamps
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        const trace_xfer_t& xfer = trace_list_[idx];
+        const pool_info_t& src_pool = pool_list_[xfer.src_idx_];
+        const pool_info_t& dst_pool = pool_list_[xfer.dst_idx_];
+        uint32_t dep_cnt = 0;
+        hsa_signal_t* dep = NULL;
+        if (xfer.after_ >= 0) {
+            dep_cnt = 1;
+            dep = &sig_list[xfer.after_];
+        } else {
+            double start_us = xfer.start_us_ - trace_list_[0].start_us_;
+            std::this_thread::sleep_until(
+                start + std::chrono::nanoseconds((uint64_t)(start_us * 1000)));
+        }
+        err_ = transport_->CopyAsync(dst_buf[xfer.dst_idx_], dst_pool.owner_agent_,
+                                     src_buf[xfer.src_idx_], src_pool.owner_agent_, xfer.size_,
+                                     dep_cnt, dep, sig_list[idx]);
+        ErrorCheck(err_);
+    }
+    WaitForCopyCompletion(sig_list);
+
+    // Replay is timed from start of its first transfer, as is the
+    // trace, so time spent before it is not counted
+    uint64_t sys_freq = 0;
+    transport_->GetSystemInfo(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+    uint64_t first_start = uint64_t(-1);
+    uint64_t last_end = 0;
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        hsa_amd_profiling_async_copy_time_t async_time = {0};
+        err_ = transport_->GetCopyTime(sig_list[idx], &async_time);
+        ErrorCheck(err_);
+        trace_list_[idx].start_ = async_time.start;
+        trace_list_[idx].end_ = async_time.end;
+        first_start = std::min(first_start, (uint64_t)async_time.start);
+        last_end = std::max(last_end, (uint64_t)async_time.end);
+    }
+    trace_replay_us_ = (double)(last_end - first_start) * 1000 * 1000 / sys_freq;
+
+    err_ = transport_->EnableProfiling(false);
+    ErrorCheck(err_);
+    ReleaseSignals(sig_list);
+    ReleaseBuffers(buf_list);
+}
+
+void RocmBandwidthTest::DisplayTrace() const {
+    PrintVersion();
+    DisplayDevInfo();
+
+    // Trace takes as long as its transfers did when captured,
+    // which is known only if every transfer has a duration
+    uint32_t xfer_cnt = trace_list_.size();
+    vector<double> end_us(xfer_cnt, 0);
+    double trace_us = 0;
+    double total_bytes = 0;
+    bool trace_known = true;
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        const trace_xfer_t& xfer = trace_list_[idx];
+        double start_us = (xfer.after_ >= 0) ? end_us[xfer.after_] : xfer.start_us_;
+        end_us[idx] = start_us + xfer.duration_us_;
+        trace_us = std::max(trace_us, end_us[idx]);
+        trace_known &= (xfer.duration_us_ >= 0);
+        total_bytes += xfer.size_;
+    }
+    trace_us -= trace_list_[0].start_us_;
+
+    // Busy time of a link is the union of times of its transfers.
+    // Data of copies within a device is doubled, as the test does
+    uint64_t sys_freq = 0;
+    transport_->GetSystemInfo(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+    std::map<std::pair<uint32_t, uint32_t>, trace_link_t> link_map;
+    for (uint32_t idx = 0; idx < xfer_cnt; idx++) {
+        const trace_xfer_t& xfer = trace_list_[idx];
+        std::pair<uint32_t, uint32_t> key(pool_list_[xfer.src_idx_].agent_index_,
+                                          pool_list_[xfer.dst_idx_].agent_index_);
+        trace_link_t& link = link_map[key];
+        link.copy_cnt_++;
+        link.bytes_ += (key.first == key.second) ? (2.0 * xfer.size_) : xfer.size_;
+        link.span_list_.push_back(std::make_pair(xfer.start_, xfer.end_));
+    }
+    std::map<std::pair<uint32_t, uint32_t>, trace_link_t>::iterator it;
+    for (it = link_map.begin(); it != link_map.end(); it++) {
+        trace_link_t& link = it->second;
+        std::sort(link.span_list_.begin(), link.span_list_.end());
+        uint64_t busy = 0;
+        uint64_t span_start = link.span_list_[0].first;
+        uint64_t span_end = link.span_list_[0].second;
+        for (uint32_t idx = 1; idx < link.span_list_.size(); idx++) {
+            if (link.span_list_[idx].first > span_end) {
+                busy += span_end - span_start;
+                span_start = link.span_list_[idx].first;
+            }
+            span_end = std::max(span_end, link.span_list_[idx].second);
+        }
+        busy += span_end - span_start;
+        link.busy_us_ = (double)busy * 1000 * 1000 / sys_freq;
+    }
+
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Trace: " << trace_file_path_ << ", transfers: " << xfer_cnt
+              << ", data: " << (total_bytes / (1024 * 1024)) << " MB" << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Trace time (ms): ";
+    if (trace_known) {
+        std::cout << (trace_us / 1000);
+    } else {
+        std::cout << "N/A";
+    }
+    std::cout << ", replay time (ms): " << (trace_replay_us_ / 1000);
+    if ((trace_known) && (trace_us > 0)) {
+        std::cout << ", replay / trace: " << (trace_replay_us_ / trace_us);
+    }
+    std::cout << std::endl;
+
+    // Utilization of a link is its busy time over time of replay
+    std::cout << std::endl;
+    const char* titles[] = {"Src", "Dst", "Copies", "Data(MB)", "Busy(ms)", "Busy(%)", "BW(GB/s)"};
+    std::cout.width(format);
+    std::cout << "";
+    for (uint32_t idx = 0; idx < 7; idx++) {
+        std::cout.width((idx < 3) ? 10 : 12);
+        std::cout << titles[idx];
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+    for (it = link_map.begin(); it != link_map.end(); it++) {
+        const trace_link_t& link = it->second;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(10);
+        std::cout << it->first.first;
+        std::cout.width(10);
+        std::cout << it->first.second;
+        std::cout.width(10);
+        std::cout << link.copy_cnt_;
+        std::cout.width(12);
+        std::cout << (link.bytes_ / (1024 * 1024));
+        std::cout.width(12);
+        std::cout << (link.busy_us_ / 1000);
+        std::cout.width(12);
+        std::cout << ((trace_replay_us_ > 0) ? (link.busy_us_ * 100 / trace_replay_us_) : 0);
+        std::cout.width(12);
+        std::cout << ((link.busy_us_ > 0) ? (link.bytes_ / link.busy_us_ / 1000) : 0);
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
@@ -75,8 +75,8 @@ bool RocmBandwidthTest::BuildReadOrWriteTrans(uint32_t req_type, vector<size_t>&
         hsa_amd_memory_pool_t pool = pool_list_[pool_idx].pool_;
 
         // Determine agent can access the memory pool
-        status = hsa_amd_agent_memory_pool_get_info(exec_agent, pool,
-                                                    HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
+        status = transport_->GetAgentPoolInfo(exec_agent, pool,
+                                              HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
         ErrorCheck(status);
 
         // Determine if accessibility to agent is not denied
@@ -93,6 +93,7 @@ bool RocmBandwidthTest::BuildReadOrWriteTrans(uint32_t req_type, vector<size_t>&
         trans.kernel.pool_idx_ = pool_idx;
         trans.kernel.agent_ = exec_agent;
         trans.kernel.agent_idx_ = exec_idx;
+        trans.trans_id_ = trans_list_.size();
         trans_list_.push_back(trans);
     }
     return true;
@@ -166,7 +167,7 @@ bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type, vector<size_t>& src_li
             }
 
             // Determine if accessibility to dst pool for src agent is not denied
-            uint32_t path_exists = access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx];
+            uint32_t path_exists = GetLinkProp(LINK_PROP_PATH, src_dev_idx, dst_dev_idx);
             if (path_exists == 0) {
                 if ((req_type == REQ_COPY_ALL_BIDIR) || (req_type == REQ_COPY_ALL_UNIDIR)) {
                     continue;
@@ -180,7 +181,7 @@ bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type, vector<size_t>& src_li
             // Both paths are valid when one of the devices is a CPU. This is
             // not true when both of the devices are GPU's.
             if ((req_type == REQ_COPY_ALL_BIDIR) || (req_type == REQ_COPY_ALL_UNIDIR)) {
-                path_exists = access_matrix_[(dst_dev_idx * agent_index_) + src_dev_idx];
+                path_exists = GetLinkProp(LINK_PROP_PATH, dst_dev_idx, src_dev_idx);
                 if (path_exists == 0) {
                     continue;
                 }
@@ -203,6 +204,7 @@ bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type, vector<size_t>& src_li
             trans.copy.bidir_ = ((req_type == REQ_COPY_BIDIR) || (req_type == REQ_COPY_ALL_BIDIR));
             trans.copy.uses_gpu_ =
                 ((src_dev_type == HSA_DEVICE_TYPE_GPU) || (dst_dev_type == HSA_DEVICE_TYPE_GPU));
+            trans.trans_id_ = trans_list_.size();
             trans_list_.push_back(trans);
         }
     }
@@ -254,7 +256,7 @@ bool RocmBandwidthTest::BuildConcurrentCopyTrans(uint32_t req_type, vector<size_
         }
 
         // Determine if accessibility to dst pool for src agent is not denied
-        uint32_t path_exists = access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx];
+        uint32_t path_exists = GetLinkProp(LINK_PROP_PATH, src_dev_idx, dst_dev_idx);
         if (path_exists == 0) {
             PrintCopyAccessError(src_idx, dst_idx);
             return false;
@@ -264,7 +266,7 @@ bool RocmBandwidthTest::BuildConcurrentCopyTrans(uint32_t req_type, vector<size_
         // Both paths are valid when one of the devices is a CPU. This is
         // not true when both of the devices are GPU's.
         if (req_type == REQ_CONCURRENT_COPY_BIDIR) {
-            path_exists = access_matrix_[(dst_dev_idx * agent_index_) + src_dev_idx];
+            path_exists = GetLinkProp(LINK_PROP_PATH, dst_dev_idx, src_dev_idx);
             if (path_exists == 0) {
                 PrintCopyAccessError(dst_idx, src_idx);
                 return false;
@@ -288,12 +290,42 @@ bool RocmBandwidthTest::BuildConcurrentCopyTrans(uint32_t req_type, vector<size_
         trans.copy.bidir_ = (req_type == REQ_CONCURRENT_COPY_BIDIR);
         trans.copy.uses_gpu_ =
             ((src_dev_type == HSA_DEVICE_TYPE_GPU) || (dst_dev_type == HSA_DEVICE_TYPE_GPU));
+        trans.trans_id_ = trans_list_.size();
         trans_list_.push_back(trans);
     }
 
     return true;
 }
 
+bool RocmBandwidthTest::BuildFanCopyTrans() {
+    // Without devices at the other end, copies fan out to
+    // or in from the first pool of every other Gpu
+    uint32_t hub_idx = fan_list_[0];
+    vector<size_t> peer_list(fan_list_.begin() + 1, fan_list_.end());
+    if (peer_list.empty()) {
+        uint32_t hub_dev_idx = pool_list_[hub_idx].agent_index_;
+        vector<bool> found(agent_index_, false);
+        uint32_t size = pool_list_.size();
+        for (uint32_t idx = 0; idx < size; idx++) {
+            uint32_t dev_idx = pool_list_[idx].agent_index_;
+            if ((dev_idx == hub_dev_idx) || (found[dev_idx]) ||
+                (agent_list_[dev_idx].device_type_ != HSA_DEVICE_TYPE_GPU)) {
+                continue;
+            }
+            found[dev_idx] = true;
+            peer_list.push_back(idx);
+        }
+    }
+
+    // Fan is run as concurrent copies between hub and each peer
+    uint32_t peer_cnt = peer_list.size();
+    for (uint32_t idx = 0; idx < peer_cnt; idx++) {
+        bidir_list_.push_back((fan_mode_ == FAN_OUT) ? hub_idx : peer_list[idx]);
+        bidir_list_.push_back((fan_mode_ == FAN_OUT) ? peer_list[idx] : hub_idx);
+    }
+    return BuildConcurrentCopyTrans(REQ_CONCURRENT_COPY_UNIDIR, bidir_list_);
+}
+
 bool RocmBandwidthTest::BuildBidirCopyTrans() {
     return BuildCopyTrans(REQ_COPY_BIDIR, bidir_list_, bidir_list_);
 }
@@ -337,6 +369,11 @@ bool RocmBandwidthTest::BuildTransList() {
         return BuildAllPoolsBidirCopyTrans();
     }
 
+    // Build list of near and far host buffer copies per user request
+    if (numa_) {
+        return BuildNumaCopyTrans();
+    }
+
     // Build list of All Unidir Copy transactions per user request
     if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
         return BuildAllPoolsUnidirCopyTrans();
@@ -347,6 +384,11 @@ bool RocmBandwidthTest::BuildTransList() {
         return BuildConcurrentCopyTrans(req_concurrent_copy_bidir_, bidir_list_);
     }
 
+    // Build list of fan-out or fan-in Copy transactions per user request
+    if (fan_mode_ != FAN_NONE) {
+        return BuildFanCopyTrans();
+    }
+
     // Build list of Unidir Concurrent Copy transactions per user request
     if (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR) {
         return BuildConcurrentCopyTrans(req_concurrent_copy_unidir_, bidir_list_);
@@ -364,22 +406,47 @@ void RocmBandwidthTest::ComputeCopyTime(std::vector<async_trans_t>& trans_list)
     }
 }
 
+double RocmBandwidthTest::ComputeCopyBandwidth(async_trans_t& trans, size_t size, double time) {
+    // Adjust size of data involved in copy
+    size_t data_size = size;
+    if (trans.copy.bidir_ == true) {
+        data_size += size;
+    }
+
+    // Double data size if copying the same device
+    if (trans.copy.src_idx_ == trans.copy.dst_idx_) {
+        data_size += data_size;
+    }
+
+    // Adjust time to units of seconds
+    if ((print_cpu_time_) || (trans.copy.uses_gpu_ != true)) {
+        time = time / 1000 / 1000 / 1000;
+    } else {
+        uint64_t sys_freq = 0;
+        transport_->GetSystemInfo(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+        time = time / sys_freq;
+    }
+
+    // Divide bandwidth with 10^9 not 1024^3 to get size in GigaBytes
+    return (double)data_size / time / 1000 / 1000 / 1000;
+}
+
 void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
     // Get the frequency of Gpu Timestamping
     uint64_t sys_freq = 0;
-    hsa_system_get_info(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+    transport_->GetSystemInfo(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
 
     double avg_time = 0;
     double min_time = 0;
     size_t data_size = 0;
     double avg_bandwidth = 0;
     double peak_bandwidth = 0;
-    uint32_t size_len = size_list_.size();
+    uint32_t size_len = trans.size_list_.size();
     for (uint32_t idx = 0; idx < size_len; idx++) {
         // Adjust size of data involved in copy
-        data_size = size_list_[idx];
+        data_size = trans.size_list_[idx];
         if (trans.copy.bidir_ == true) {
-            data_size += size_list_[idx];
+            data_size += trans.size_list_[idx];
         }
 
         // Double data size if copying the same device
@@ -426,6 +493,13 @@ void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
             peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
         }
 
+        // Convert statistics of copy times to units of seconds
+        if ((collect_stats_) && (verify_status == HSA_STATUS_SUCCESS)) {
+            bool cpu_time = ((print_cpu_time_) || (trans.copy.uses_gpu_ != true));
+            double scale = (cpu_time) ? (1.0 / 1000 / 1000 / 1000) : (1.0 / sys_freq);
+            ScaleStats(trans.stats_[idx], scale);
+        }
+
         // Update computed bandwidth for the transaction
         trans.min_time_.push_back(min_time);
         trans.avg_time_.push_back(avg_time);
@@ -142,6 +142,11 @@ bool RocmBandwidthTest::ValidateConcurrentCopyReq() {
     return PoolIsPresent(bidir_list_);
 }
 
+bool RocmBandwidthTest::ValidateFanCopyReq() {
+    // Same pool can't be at both ends of a fan
+    return ValidateCopyReq(fan_list_);
+}
+
 bool RocmBandwidthTest::ValidateArguments() {
     // Determine if user has requested a READ
     // operation and gave valid inputs
@@ -174,6 +179,9 @@ bool RocmBandwidthTest::ValidateArguments() {
     // Determine if user has requested a Concurrent
     // Copy operation that is unidirectional or bidirectional
     // and gave valid inputs.
+    if (fan_mode_ != FAN_NONE) {
+        return ValidateFanCopyReq();
+    }
     if ((req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
         (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR)) {
         return ValidateConcurrentCopyReq();
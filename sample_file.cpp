@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sample_file.hpp"
+
+#include <string.h>
+
+// Size of stdio buffer used to stage records
+#define SAMPLE_FILE_BUFFER_SIZE (1024 * 1024)
+
+SampleFileWriter::SampleFileWriter() { file_ = NULL; }
+
+SampleFileWriter::~SampleFileWriter() { Close(); }
+
+bool SampleFileWriter::Open(const std::string& path, uint64_t timestamp_freq) {
+    file_ = fopen(path.c_str(), "wb");
+    if (file_ == NULL) {
+        return false;
+    }
+    setvbuf(file_, NULL, _IOFBF, SAMPLE_FILE_BUFFER_SIZE);
+
+    sample_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic_, SAMPLE_FILE_MAGIC, sizeof(SAMPLE_FILE_MAGIC));
+    header.version_ = SAMPLE_FILE_VERSION;
+    header.header_size_ = sizeof(sample_file_header_t);
+    header.record_size_ = sizeof(sample_record_t);
+    header.timestamp_freq_ = timestamp_freq;
+    return (fwrite(&header, sizeof(header), 1, file_) == 1);
+}
+
+bool SampleFileWriter::Write(const sample_record_t& record) {
+    return (fwrite(&record, sizeof(record), 1, file_) == 1);
+}
+
+bool SampleFileWriter::Close() {
+    if (file_ == NULL) {
+        return true;
+    }
+    int status = fclose(file_);
+    file_ = NULL;
+    return (status == 0);
+}
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_SAMPLE_FILE_HPP
+#define ROC_BANDWIDTH_TEST_SAMPLE_FILE_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+
+// Layout of file used to export copy times of every iteration.
+// File begins with a header followed by fixed size records, one
+// per iteration, written in host byte order as collected. Readers
+// must reject a file whose magic or version they do not recognize
+// and should skip header_size_ bytes and read records of size
+// record_size_ to remain compatible with future additions
+#define SAMPLE_FILE_MAGIC "RBTSMPL"
+#define SAMPLE_FILE_VERSION 1
+
+// Status of verification of destination buffer of a copy
+#define SAMPLE_VERIFY_NONE 0
+#define SAMPLE_VERIFY_PASS 1
+#define SAMPLE_VERIFY_FAIL 2
+
+// Flags describing how a sample was collected
+#define SAMPLE_FLAG_BIDIR 0x1
+#define SAMPLE_FLAG_CONCURRENT 0x2
+#define SAMPLE_FLAG_CPU_TIME 0x4
+
+// Header of sample file. Gpu ticks are converted to seconds
+// by dividing them by the timestamp frequency recorded here
+typedef struct sample_file_header {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t header_size_;
+        uint32_t record_size_;
+        uint32_t reserved_;
+        uint64_t timestamp_freq_;
+} sample_file_header_t;
+
+// Record of one iteration of a copy transaction. Gpu ticks are
+// obtained from the profiling info of the copy signals and are
+// zero if not collected. Cpu timestamps are in nanoseconds of
+// the steady clock and bracket the submit and wait of copies.
+// Source and destination are given as indices of pools, as used
+// by options -s and -d, and of the devices owning them
+typedef struct sample_record {
+        uint32_t trans_id_;
+        uint32_t iteration_;
+        uint64_t size_;
+        uint64_t gpu_start_fwd_;
+        uint64_t gpu_end_fwd_;
+        uint64_t gpu_start_rev_;
+        uint64_t gpu_end_rev_;
+        uint64_t cpu_start_;
+        uint64_t cpu_end_;
+        uint32_t verify_status_;
+        uint32_t flags_;
+        uint32_t src_pool_idx_;
+        uint32_t dst_pool_idx_;
+        uint32_t src_dev_idx_;
+        uint32_t dst_dev_idx_;
+} sample_record_t;
+
+// @brief: Writes samples to a file as they are collected. Records
+// are staged in the buffer of stdio stream, so writing one does
+// not allocate memory nor issue a system call
+class SampleFileWriter {
+    public:
+        SampleFileWriter();
+        ~SampleFileWriter();
+
+        // @brief: Create the file and write its header
+        bool Open(const std::string& path, uint64_t timestamp_freq);
+
+        // @brief: Append a record to the file
+        bool Write(const sample_record_t& record);
+
+        // @brief: Flush pending records and close the file
+        bool Close();
+
+        bool IsOpen() const { return (file_ != NULL); }
+
+    private:
+        FILE* file_;
+};
+
+#endif  //  ROC_BANDWIDTH_TEST_SAMPLE_FILE_HPP
@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "stats.hpp"
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+double CalcQuantile(const vector<double>& sorted, double q) {
+    size_t size = sorted.size();
+    if (size == 0) {
+        return 0;
+    }
+
+    // Interpolate linearly between the two closest ranks
+    double rank = q * (size - 1);
+    size_t lo = (size_t)std::floor(rank);
+    size_t hi = (size_t)std::ceil(rank);
+    double frac = rank - lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+int32_t GetHistBucket(double value) {
+    if (value <= 0) {
+        return 0;
+    }
+    return (int32_t)std::floor(std::log2(value) * STATS_HIST_BUCKETS_PER_OCTAVE);
+}
+
+double GetHistBucketBound(int32_t bucket) {
+    return std::exp2((double)bucket / STATS_HIST_BUCKETS_PER_OCTAVE);
+}
+
+// Bootstrap the 95% confidence interval of mean by resampling
+// with replacement. Seed is fixed so reruns over the same data
+// report the same interval
+static void BootstrapMeanInterval(const vector<double>& samples, stats_summary_t& summary) {
+    size_t size = samples.size();
+    std::mt19937_64 engine(0x11231926);
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+
+    vector<double> means(STATS_BOOTSTRAP_RESAMPLES);
+    for (uint32_t idx = 0; idx < STATS_BOOTSTRAP_RESAMPLES; idx++) {
+        double sum = 0;
+        for (size_t jdx = 0; jdx < size; jdx++) {
+            sum += samples[pick(engine)];
+        }
+        means[idx] = sum / size;
+    }
+
+    std::sort(means.begin(), means.end());
+    summary.ci_low_ = CalcQuantile(means, 0.025);
+    summary.ci_high_ = CalcQuantile(means, 0.975);
+}
+
+void ComputeStats(vector<double>& samples, stats_summary_t& summary) {
+    summary = stats_summary_t();
+    summary.count_ = samples.size();
+    if (summary.count_ == 0) {
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    summary.min_ = samples.front();
+    summary.max_ = samples.back();
+    summary.mean_ = CalcMean(samples);
+    summary.median_ = CalcMedian(samples);
+    summary.p90_ = CalcQuantile(samples, 0.90);
+    summary.p99_ = CalcQuantile(samples, 0.99);
+    summary.p999_ = CalcQuantile(samples, 0.999);
+    summary.std_dev_ = CalcStdDeviation(samples, summary.mean_);
+    summary.coeff_var_ = (summary.mean_ > 0) ? (summary.std_dev_ / summary.mean_) : 0;
+    BootstrapMeanInterval(samples, summary);
+
+    // Bucket the samples, which are sorted already
+    summary.hist_base_ = GetHistBucket(summary.min_);
+    int32_t last = GetHistBucket(summary.max_);
+    summary.hist_.assign(last - summary.hist_base_ + 1, 0);
+    for (size_t idx = 0; idx < samples.size(); idx++) {
+        summary.hist_[GetHistBucket(samples[idx]) - summary.hist_base_]++;
+    }
+}
+
+void ScaleStats(stats_summary_t& summary, double scale) {
+    summary.min_ *= scale;
+    summary.max_ *= scale;
+    summary.mean_ *= scale;
+    summary.median_ *= scale;
+    summary.p90_ *= scale;
+    summary.p99_ *= scale;
+    summary.p999_ *= scale;
+    summary.std_dev_ *= scale;
+    summary.ci_low_ *= scale;
+    summary.ci_high_ *= scale;
+    summary.hist_scale_ *= scale;
+}
+
+SampleAccumulator::SampleAccumulator() {
+    double gamma = (1 + STATS_SKETCH_ACCURACY) / (1 - STATS_SKETCH_ACCURACY);
+    log_gamma_ = std::log(gamma);
+    Reset();
+}
+
+void SampleAccumulator::Reset() {
+    count_ = 0;
+    min_ = max_ = mean_ = m2_ = 0;
+    offset_ = 0;
+    zero_count_ = 0;
+    std::memset(buckets_, 0, sizeof(buckets_));
+}
+
+void SampleAccumulator::Add(double value) {
+    // Update min, max, mean and sum of squared deviations
+    count_++;
+    min_ = (count_ == 1) ? value : std::min(min_, value);
+    max_ = (count_ == 1) ? value : std::max(max_, value);
+    double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+
+    // Samples that are not positive have no log bucket
+    if (value <= 0) {
+        zero_count_++;
+        return;
+    }
+
+    // Center the sketch on the first positive sample
+    int32_t index = (int32_t)std::ceil(std::log(value) / log_gamma_);
+    if ((count_ - zero_count_) == 1) {
+        offset_ = index - (STATS_SKETCH_BUCKETS / 2);
+    }
+    int32_t slot = index - offset_;
+    slot = std::max(0, std::min(slot, STATS_SKETCH_BUCKETS - 1));
+    buckets_[slot]++;
+}
+
+double SampleAccumulator::Variance() const {
+    return (count_ < 2) ? 0 : (m2_ / (count_ - 1));
+}
+
+double SampleAccumulator::BucketValue(int32_t index) const {
+    double gamma = std::exp(log_gamma_);
+    return (2 * std::pow(gamma, index)) / (gamma + 1);
+}
+
+double SampleAccumulator::Quantile(double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    // Walk the buckets until the rank of quantile is covered
+    // Estimate is clamped to the exact min and max values
+    uint64_t rank = (uint64_t)(q * (count_ - 1));
+    if (rank < zero_count_) {
+        return min_;
+    }
+    uint64_t seen = zero_count_;
+    for (int32_t slot = 0; slot < STATS_SKETCH_BUCKETS; slot++) {
+        seen += buckets_[slot];
+        if (seen > rank) {
+            double value = BucketValue(slot + offset_);
+            return std::max(min_, std::min(value, max_));
+        }
+    }
+    return max_;
+}
+
+void SampleAccumulator::Summarize(stats_summary_t& summary) const {
+    summary = stats_summary_t();
+    summary.count_ = count_;
+    if (count_ == 0) {
+        return;
+    }
+
+    summary.min_ = min_;
+    summary.max_ = max_;
+    summary.mean_ = mean_;
+    summary.median_ = Quantile(0.5);
+    summary.p90_ = Quantile(0.90);
+    summary.p99_ = Quantile(0.99);
+    summary.p999_ = Quantile(0.999);
+    summary.std_dev_ = std::sqrt(Variance());
+    summary.coeff_var_ = (mean_ > 0) ? (summary.std_dev_ / mean_) : 0;
+    double margin = 1.96 * summary.std_dev_ / std::sqrt((double)count_);
+    summary.ci_low_ = mean_ - margin;
+    summary.ci_high_ = mean_ + margin;
+
+    // Fold the buckets of sketch into the coarser histogram buckets
+    summary.hist_base_ = GetHistBucket(min_);
+    int32_t last = GetHistBucket(max_);
+    summary.hist_.assign(last - summary.hist_base_ + 1, 0);
+    summary.hist_[0] += zero_count_;
+    for (int32_t slot = 0; slot < STATS_SKETCH_BUCKETS; slot++) {
+        if (buckets_[slot] == 0) {
+            continue;
+        }
+        double value = std::max(min_, std::min(BucketValue(slot + offset_), max_));
+        int32_t bucket = GetHistBucket(value) - summary.hist_base_;
+        bucket = std::max(0, std::min(bucket, last - summary.hist_base_));
+        summary.hist_[bucket] += buckets_[slot];
+    }
+}
+
+// @brief: Evaluate continued fraction of incomplete beta function
+// by modified Lentz's method
+static double calcBetaFraction(double a, double b, double x) {
+    const double tiny = 1e-300;
+    double qab = a + b;
+    double qap = a + 1;
+    double qam = a - 1;
+    double c = 1;
+    double d = 1 - qab * x / qap;
+    d = (std::fabs(d) < tiny) ? tiny : d;
+    d = 1 / d;
+    double h = d;
+    for (int32_t m = 1; m <= 200; m++) {
+        int32_t m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1 + aa * d;
+        d = (std::fabs(d) < tiny) ? tiny : d;
+        c = 1 + aa / c;
+        c = (std::fabs(c) < tiny) ? tiny : c;
+        d = 1 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1 + aa * d;
+        d = (std::fabs(d) < tiny) ? tiny : d;
+        c = 1 + aa / c;
+        c = (std::fabs(c) < tiny) ? tiny : c;
+        d = 1 / d;
+        double del = d * c;
+        h *= del;
+        if (std::fabs(del - 1) < 1e-12) {
+            break;
+        }
+    }
+    return h;
+}
+
+// @brief: Return regularized incomplete beta function I_x(a, b)
+static double calcIncompleteBeta(double a, double b, double x) {
+    if ((x <= 0) || (x >= 1)) {
+        return (x <= 0) ? 0 : 1;
+    }
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                            a * std::log(x) + b * std::log(1 - x));
+    if (x < (a + 1) / (a + b + 2)) {
+        return front * calcBetaFraction(a, b, x) / a;
+    }
+    return 1 - front * calcBetaFraction(b, a, 1 - x) / b;
+}
+
+double CalcWelchPValue(double mean_a, double var_a, uint64_t count_a, double mean_b,
+                       double var_b, uint64_t count_b) {
+    if ((count_a < 2) || (count_b < 2)) {
+        return 1;
+    }
+
+    // Samples without spread differ for sure if their means do
+    double se_a = var_a / count_a;
+    double se_b = var_b / count_b;
+    double se = se_a + se_b;
+    if (se <= 0) {
+        return (mean_a > mean_b) ? 0 : 1;
+    }
+
+    // Degrees of freedom by Welch-Satterthwaite equation
+    double t = (mean_a - mean_b) / std::sqrt(se);
+    double df = (se * se) / ((se_a * se_a) / (count_a - 1) + (se_b * se_b) / (count_b - 1));
+
+    // Tail probability of Student's t distribution
+    double tail = 0.5 * calcIncompleteBeta(df / 2, 0.5, df / (df + t * t));
+    return (t > 0) ? tail : (1 - tail);
+}
@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_STATS_HPP
+#define ROC_BANDWIDTH_TEST_STATS_HPP
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Number of histogram buckets per doubling of time. Bucket
+// b holds samples in the range [2^(b/8), 2^((b+1)/8))
+#define STATS_HIST_BUCKETS_PER_OCTAVE 8
+
+// Number of resamples used to bootstrap confidence interval
+#define STATS_BOOTSTRAP_RESAMPLES 1000
+
+// Structure to encapsulate the summary statistics of
+// copy times measured for one buffer size
+typedef struct stats_summary {
+        stats_summary() {
+            count_ = 0;
+            min_ = max_ = mean_ = median_ = 0;
+            p90_ = p99_ = p999_ = 0;
+            std_dev_ = coeff_var_ = 0;
+            ci_low_ = ci_high_ = 0;
+            hist_base_ = 0;
+            hist_scale_ = 1;
+        }
+
+        uint64_t count_;
+        double min_;
+        double max_;
+        double mean_;
+        double median_;
+        double p90_;
+        double p99_;
+        double p999_;
+        double std_dev_;
+
+        // Ratio of standard deviation to mean, unit-less
+        double coeff_var_;
+
+        // Bounds of 95% confidence interval of mean
+        double ci_low_;
+        double ci_high_;
+
+        // Log-bucketed histogram. The first element counts samples
+        // of bucket hist_base_. Bucket bounds are in units of the
+        // samples, multiplied by hist_scale_
+        int32_t hist_base_;
+        double hist_scale_;
+        vector<uint64_t> hist_;
+
+} stats_summary_t;
+
+// Number of buckets of the quantile sketch and the relative
+// accuracy of quantiles it returns. Sketch spans a range of
+// gamma^2048 i.e. over 10^17 between its smallest and largest
+// bucket, with gamma = (1 + accuracy) / (1 - accuracy)
+#define STATS_SKETCH_BUCKETS 2048
+#define STATS_SKETCH_ACCURACY 0.01
+
+// @brief: Accumulates samples in constant memory. Tracks min, max,
+// mean and variance exactly (Welford) and quantiles approximately
+// using log-spaced buckets, as done by DDSketch. A sample's bucket
+// is ceil(log_gamma(value)), whose midpoint is within accuracy of
+// every value in it. Adding a sample never allocates memory
+class SampleAccumulator {
+    public:
+        SampleAccumulator();
+
+        // @brief: Discard all samples accumulated so far
+        void Reset();
+
+        // @brief: Accumulate one sample
+        void Add(double value);
+
+        uint64_t Count() const { return count_; }
+        double Min() const { return min_; }
+        double Max() const { return max_; }
+        double Mean() const { return mean_; }
+        double Sum() const { return mean_ * count_; }
+
+        // @brief: Return sample variance of the samples
+        double Variance() const;
+
+        // @brief: Return estimate of value at quantile q
+        double Quantile(double q) const;
+
+        // @brief: Summarize the samples. Confidence interval is derived
+        // from normal approximation as samples are not retained
+        void Summarize(stats_summary_t& summary) const;
+
+    private:
+        // @brief: Map bucket index to the value it represents
+        double BucketValue(int32_t index) const;
+
+        uint64_t count_;
+        double min_;
+        double max_;
+        double mean_;
+        double m2_;
+
+        // Index of value held by first bucket of sketch. Values
+        // outside the range of sketch collapse into its end buckets
+        int32_t offset_;
+        double log_gamma_;
+        uint64_t zero_count_;
+        uint32_t buckets_[STATS_SKETCH_BUCKETS];
+};
+
+// @brief: Compute summary statistics of a list of samples.
+// The list is sorted in the process
+void ComputeStats(vector<double>& samples, stats_summary_t& summary);
+
+// @brief: Scale the values of a summary e.g. to convert
+// its units from timer ticks to seconds
+void ScaleStats(stats_summary_t& summary, double scale);
+
+// @brief: Return the value at quantile q of a sorted list
+double CalcQuantile(const vector<double>& sorted, double q);
+
+// @brief: Return index of histogram bucket that holds value
+int32_t GetHistBucket(double value);
+
+// @brief: Return lower bound of a histogram bucket
+double GetHistBucketBound(int32_t bucket);
+
+// @brief: Return one-sided p-value of Welch's t-test for the
+// hypothesis that mean of sample a is larger than mean of sample b,
+// given the mean, sample variance and count of each sample
+double CalcWelchPValue(double mean_a, double var_a, uint64_t count_a, double mean_b,
+                       double var_b, uint64_t count_b);
+
+#endif    // ROC_BANDWIDTH_TEST_STATS_HPP
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Converts a file of copy times exported by rocm-bandwidth-test
+// using its -R option into CSV format, one row per iteration
+
+#include "../sample_file.hpp"
+
+#include <string.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static void PrintUsage(const char* name) {
+    std::cout << "Usage: " << name << " <sample file> [<csv file>]" << std::endl;
+    std::cout << "  Writes CSV to stdout if csv file is not specified" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if ((argc != 2) && (argc != 3)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* input = fopen(argv[1], "rb");
+    if (input == NULL) {
+        std::cout << "Unable to open sample file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Validate header of the file
+    sample_file_header_t header;
+    if ((fread(&header, sizeof(header), 1, input) != 1) ||
+        (memcmp(header.magic_, SAMPLE_FILE_MAGIC, sizeof(SAMPLE_FILE_MAGIC)) != 0)) {
+        std::cout << "Not a sample file: " << argv[1] << std::endl;
+        fclose(input);
+        return 1;
+    }
+    if ((header.version_ != SAMPLE_FILE_VERSION) ||
+        (header.header_size_ < sizeof(sample_file_header_t)) ||
+        (header.record_size_ < sizeof(sample_record_t))) {
+        std::cout << "Unsupported version of sample file: " << header.version_ << std::endl;
+        fclose(input);
+        return 1;
+    }
+    fseek(input, header.header_size_, SEEK_SET);
+
+    FILE* output = stdout;
+    if (argc == 3) {
+        output = fopen(argv[2], "w");
+        if (output == NULL) {
+            std::cout << "Unable to create csv file: " << argv[2] << std::endl;
+            fclose(input);
+            return 1;
+        }
+    }
+
+    // Records may be larger than the ones known to this reader
+    fprintf(output, "trans_id,src_pool,dst_pool,src_dev,dst_dev,");
+    fprintf(output, "iteration,size,bidir,concurrent,cpu_time,");
+    fprintf(output, "gpu_start_fwd,gpu_end_fwd,gpu_start_rev,gpu_end_rev,");
+    fprintf(output, "cpu_start_ns,cpu_end_ns,verify,gpu_time_us,cpu_time_us\n");
+    std::vector<char> buffer(header.record_size_);
+    const char* verify_str[] = {"none", "pass", "fail"};
+    while (fread(buffer.data(), header.record_size_, 1, input) == 1) {
+        sample_record_t rec;
+        memcpy(&rec, buffer.data(), sizeof(rec));
+
+        // Time of bidir copy spans both directions
+        uint64_t gpu_start = rec.gpu_start_fwd_;
+        uint64_t gpu_end = rec.gpu_end_fwd_;
+        if (rec.flags_ & SAMPLE_FLAG_BIDIR) {
+            gpu_start = (rec.gpu_start_rev_ < gpu_start) ? rec.gpu_start_rev_ : gpu_start;
+            gpu_end = (rec.gpu_end_rev_ > gpu_end) ? rec.gpu_end_rev_ : gpu_end;
+        }
+        double gpu_time = 0;
+        if (header.timestamp_freq_ != 0) {
+            gpu_time = (double)(gpu_end - gpu_start) * 1e6 / header.timestamp_freq_;
+        }
+        double cpu_time = (double)(rec.cpu_end_ - rec.cpu_start_) / 1e3;
+        uint32_t verify = (rec.verify_status_ <= SAMPLE_VERIFY_FAIL) ? rec.verify_status_ : 0;
+
+        fprintf(output, "%u,%u,%u,%u,%u,", rec.trans_id_, rec.src_pool_idx_, rec.dst_pool_idx_,
+                rec.src_dev_idx_, rec.dst_dev_idx_);
+        fprintf(output, "%u,%llu,%d,%d,%d,", rec.iteration_,
+                (unsigned long long)rec.size_, (rec.flags_ & SAMPLE_FLAG_BIDIR) ? 1 : 0,
+                (rec.flags_ & SAMPLE_FLAG_CONCURRENT) ? 1 : 0,
+                (rec.flags_ & SAMPLE_FLAG_CPU_TIME) ? 1 : 0);
+        fprintf(output, "%llu,%llu,%llu,%llu,", (unsigned long long)rec.gpu_start_fwd_,
+                (unsigned long long)rec.gpu_end_fwd_, (unsigned long long)rec.gpu_start_rev_,
+                (unsigned long long)rec.gpu_end_rev_);
+        fprintf(output, "%llu,%llu,%s,%.3f,%.3f\n", (unsigned long long)rec.cpu_start_,
+                (unsigned long long)rec.cpu_end_, verify_str[verify], gpu_time, cpu_time);
+    }
+
+    fclose(input);
+    if (output != stdout) {
+        fclose(output);
+    }
+    return 0;
+}
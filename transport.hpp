@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_TRANSPORT_HPP
+#define ROC_BANDWIDTH_TEST_TRANSPORT_HPP
+
+#include "hsa/hsa.h"
+#include "hsa/hsa_ext_amd.h"
+
+#include <stdint.h>
+
+#include <string>
+
+// @brief: Interface through which the test discovers devices and
+// memory pools, allocates buffers and submits, waits on and times
+// copies. Methods mirror the RocR calls they replace, take the same
+// handles and return the same status codes, so the engine is
+// unaware of which implementation it runs against
+class Transport {
+    public:
+        virtual ~Transport() {}
+
+        // @brief: Name of transport as printed in reports
+        virtual const char* GetName() const = 0;
+
+        virtual hsa_status_t Init() = 0;
+        virtual hsa_status_t ShutDown() = 0;
+        virtual hsa_status_t GetSystemInfo(hsa_system_info_t attribute, void* value) = 0;
+
+        // Discovery of agents, their pools and links between them
+        virtual hsa_status_t IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                           void* data) = 0;
+        virtual hsa_status_t GetAgentInfo(hsa_agent_t agent, hsa_agent_info_t attribute,
+                                          void* value) = 0;
+        virtual hsa_status_t IteratePools(hsa_agent_t agent,
+                                          hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                                   void* data),
+                                          void* data) = 0;
+        virtual hsa_status_t GetPoolInfo(hsa_amd_memory_pool_t pool,
+                                         hsa_amd_memory_pool_info_t attribute, void* value) = 0;
+        virtual hsa_status_t GetAgentPoolInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                              hsa_amd_agent_memory_pool_info_t attribute,
+                                              void* value) = 0;
+
+        // Buffers and their access by agents other than owner
+        virtual hsa_status_t Allocate(hsa_amd_memory_pool_t pool, size_t size, void** ptr) = 0;
+        virtual hsa_status_t Free(void* ptr) = 0;
+        virtual hsa_status_t AllowAccess(hsa_agent_t agent, const void* ptr) = 0;
+
+        // Signals that gate and report completion of copies
+        virtual hsa_status_t CreateSignal(hsa_signal_value_t value, hsa_signal_t* signal) = 0;
+        virtual hsa_status_t DestroySignal(hsa_signal_t signal) = 0;
+        virtual void StoreSignal(hsa_signal_t signal, hsa_signal_value_t value) = 0;
+        virtual hsa_signal_value_t WaitSignal(hsa_signal_t signal,
+                                              hsa_signal_condition_t condition,
+                                              hsa_signal_value_t value,
+                                              hsa_wait_state_t policy) = 0;
+
+        // Submission and timing of copies
+        virtual hsa_status_t CopyAsync(void* dst, hsa_agent_t dst_agent, const void* src,
+                                       hsa_agent_t src_agent, size_t size, uint32_t num_deps,
+                                       const hsa_signal_t* deps, hsa_signal_t signal) = 0;
+        virtual hsa_status_t EnableProfiling(bool enable) = 0;
+        virtual hsa_status_t GetCopyTime(hsa_signal_t signal,
+                                         hsa_amd_profiling_async_copy_time_t* time) = 0;
+};
+
+// @brief: Transport that forwards every call to RocR
+Transport* CreateHsaTransport();
+
+// @brief: Transport that simulates the devices and links described
+// by config file, exits test if file can't be read or is illegal
+Transport* CreateSimTransport(const std::string& config_path);
+
+#endif    //  ROC_BANDWIDTH_TEST_TRANSPORT_HPP
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "transport.hpp"
+
+// @brief: Transport that forwards every call to RocR
+class HsaTransport : public Transport {
+    public:
+        const char* GetName() const { return "hsa"; }
+
+        hsa_status_t Init() { return hsa_init(); }
+
+        hsa_status_t ShutDown() { return hsa_shut_down(); }
+
+        hsa_status_t GetSystemInfo(hsa_system_info_t attribute, void* value) {
+            return hsa_system_get_info(attribute, value);
+        }
+
+        hsa_status_t IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                   void* data) {
+            return hsa_iterate_agents(callback, data);
+        }
+
+        hsa_status_t GetAgentInfo(hsa_agent_t agent, hsa_agent_info_t attribute, void* value) {
+            return hsa_agent_get_info(agent, attribute, value);
+        }
+
+        hsa_status_t IteratePools(hsa_agent_t agent,
+                                  hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                           void* data),
+                                  void* data) {
+            return hsa_amd_agent_iterate_memory_pools(agent, callback, data);
+        }
+
+        hsa_status_t GetPoolInfo(hsa_amd_memory_pool_t pool, hsa_amd_memory_pool_info_t attribute,
+                                 void* value) {
+            return hsa_amd_memory_pool_get_info(pool, attribute, value);
+        }
+
+        hsa_status_t GetAgentPoolInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                      hsa_amd_agent_memory_pool_info_t attribute, void* value) {
+            return hsa_amd_agent_memory_pool_get_info(agent, pool, attribute, value);
+        }
+
+        hsa_status_t Allocate(hsa_amd_memory_pool_t pool, size_t size, void** ptr) {
+            return hsa_amd_memory_pool_allocate(pool, size, 0, ptr);
+        }
+
+        hsa_status_t Free(void* ptr) { return hsa_amd_memory_pool_free(ptr); }
+
+        hsa_status_t AllowAccess(hsa_agent_t agent, const void* ptr) {
+            return hsa_amd_agents_allow_access(1, &agent, NULL, ptr);
+        }
+
+        hsa_status_t CreateSignal(hsa_signal_value_t value, hsa_signal_t* signal) {
+            return hsa_signal_create(value, 0, NULL, signal);
+        }
+
+        hsa_status_t DestroySignal(hsa_signal_t signal) { return hsa_signal_destroy(signal); }
+
+        void StoreSignal(hsa_signal_t signal, hsa_signal_value_t value) {
+            hsa_signal_store_relaxed(signal, value);
+        }
+
+        hsa_signal_value_t WaitSignal(hsa_signal_t signal, hsa_signal_condition_t condition,
+                                      hsa_signal_value_t value, hsa_wait_state_t policy) {
+            return hsa_signal_wait_acquire(signal, condition, value, uint64_t(-1), policy);
+        }
+
+        hsa_status_t CopyAsync(void* dst, hsa_agent_t dst_agent, const void* src,
+                               hsa_agent_t src_agent, size_t size, uint32_t num_deps,
+                               const hsa_signal_t* deps, hsa_signal_t signal) {
+            return hsa_amd_memory_async_copy(dst, dst_agent, src, src_agent, size, num_deps, deps,
+                                             signal);
+        }
+
+        hsa_status_t EnableProfiling(bool enable) {
+            return hsa_amd_profiling_async_copy_enable(enable);
+        }
+
+        hsa_status_t GetCopyTime(hsa_signal_t signal, hsa_amd_profiling_async_copy_time_t* time) {
+            return hsa_amd_profiling_get_async_copy_time(signal, time);
+        }
+};
+
+Transport* CreateHsaTransport() { return new HsaTransport(); }
@@ -0,0 +1,870 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "transport.hpp"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Pools of a device, in the order they are reported. Cpu offers a
+// fine-grained kernarg pool and a coarse-grained one, Gpu offers a
+// coarse-grained pool and a fine-grained one
+static const uint32_t SIM_CPU_POOL_FLAGS[] = {
+    HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_KERNARG_INIT | HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_FINE_GRAINED,
+    HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_COARSE_GRAINED};
+static const uint32_t SIM_GPU_POOL_FLAGS[] = {HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_COARSE_GRAINED,
+                                              HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_FINE_GRAINED};
+static const uint32_t SIM_POOLS_PER_DEVICE = 2;
+
+// Names of link types accepted by config file
+static const struct {
+        const char* name_;
+        hsa_amd_link_info_type_t type_;
+} SIM_LINK_TYPES[] = {{"hypertransport", HSA_AMD_LINK_INFO_TYPE_HYPERTRANSPORT},
+                      {"qpi", HSA_AMD_LINK_INFO_TYPE_QPI},
+                      {"pcie", HSA_AMD_LINK_INFO_TYPE_PCIE},
+                      {"infiniband", HSA_AMD_LINK_INFO_TYPE_INFINBAND},
+                      {"xgmi", HSA_AMD_LINK_INFO_TYPE_XGMI}};
+
+// Device as described by config file
+typedef struct sim_device {
+        hsa_device_type_t type_;
+        std::string name_;
+        size_t pool_size_;
+        uint32_t bdf_id_;
+
+        // Model of copies within memory of the device
+        double bandwidth_;
+        double latency_;
+} sim_device_t;
+
+// Link binding two devices, used by copies in either direction
+typedef struct sim_link {
+        uint32_t dev1_;
+        uint32_t dev2_;
+        hsa_amd_link_info_type_t type_;
+        uint32_t hops_;
+        uint32_t weight_;
+
+        // Bandwidth in GB/s and latency in microseconds
+        // of each direction
+        double bandwidth_;
+        double latency_;
+} sim_link_t;
+
+// Buffer allocated from a pool of a device
+typedef struct sim_alloc {
+        size_t size_;
+        uint32_t pool_;
+} sim_alloc_t;
+
+// Copy in one direction between two devices, or within one,
+// that takes duration nanoseconds once it starts
+struct sim_signal;
+typedef struct sim_copy {
+        std::pair<int32_t, int32_t> channel_;
+        uint64_t duration_;
+        struct sim_signal* signal_;
+} sim_copy_t;
+
+// Signal whose value drops by one as each of its copies completes.
+// Copies gated by signal start when its value is set to zero
+typedef struct sim_signal {
+        hsa_signal_value_t value_;
+        vector<uint64_t> done_list_;
+        vector<sim_copy_t> gated_list_;
+        uint64_t start_;
+        uint64_t end_;
+} sim_signal_t;
+
+// Data of a copy, moved by host once its signal is waited upon
+typedef struct sim_move {
+        void* dst_;
+        const void* src_;
+        size_t size_;
+        sim_signal_t* signal_;
+} sim_move_t;
+
+static uint64_t getSimTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static std::string trimSimString(const std::string& str) {
+    const char* space = " \t\r\n";
+    size_t first = str.find_first_not_of(space);
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = str.find_last_not_of(space);
+    return str.substr(first, (last - first) + 1);
+}
+
+static void exitSimError(const std::string& path, uint32_t line, const std::string& msg) {
+    std::cout << "Simulation config " << path << ", line " << line << ": " << msg << std::endl;
+    exit_test(1);
+}
+
+// Parse value as a number in [min, max], returns false if illegal
+static bool parseSimNumber(const std::string& value, double min, double max, double& num) {
+    char* end = NULL;
+    num = strtod(value.c_str(), &end);
+    return ((end != value.c_str()) && (*end == '\0') && (num >= min) && (num <= max));
+}
+
+// @brief: Transport that simulates devices and links of a config
+// file. Buffers are allocated from host memory and copies move data
+// for real, so validation works, while their time is modelled as
+// latency plus size over bandwidth of the link they use. Copies in
+// the same direction of a link are serialized, others overlap.
+// Signals complete when the modelled time has passed, so timing by
+// Cpu agrees with timestamps reported for copies
+class SimTransport : public Transport {
+    public:
+        SimTransport(const std::string& config_path) : config_path_(config_path), ref_cnt_(0) {
+            LoadConfig();
+        }
+
+        ~SimTransport() {
+            std::map<uintptr_t, sim_alloc_t>::iterator it;
+            for (it = alloc_map_.begin(); it != alloc_map_.end(); it++) {
+                free((void*)it->first);
+            }
+        }
+
+        const char* GetName() const { return "simulated"; }
+
+        hsa_status_t Init() {
+            ref_cnt_++;
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t ShutDown() {
+            if (ref_cnt_ == 0) {
+                return HSA_STATUS_ERROR_NOT_INITIALIZED;
+            }
+            ref_cnt_--;
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t GetSystemInfo(hsa_system_info_t attribute, void* value) {
+            switch (attribute) {
+                case HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY:
+                    *(uint64_t*)value = 1000000000;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_SYSTEM_INFO_VERSION_MAJOR:
+                    *(uint16_t*)value = 1;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_SYSTEM_INFO_VERSION_MINOR:
+                    *(uint16_t*)value = 0;
+                    return HSA_STATUS_SUCCESS;
+                default:
+                    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+        }
+
+        hsa_status_t IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                   void* data) {
+            if (ref_cnt_ == 0) {
+                return HSA_STATUS_ERROR_NOT_INITIALIZED;
+            }
+            for (uint32_t idx = 0; idx < dev_list_.size(); idx++) {
+                hsa_agent_t agent = {idx + 1};
+                hsa_status_t status = callback(agent, data);
+                if (status == HSA_STATUS_INFO_BREAK) {
+                    return HSA_STATUS_SUCCESS;
+                }
+                if (status != HSA_STATUS_SUCCESS) {
+                    return status;
+                }
+            }
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t GetAgentInfo(hsa_agent_t agent, hsa_agent_info_t attribute, void* value) {
+            if (ValidAgent(agent) == false) {
+                return HSA_STATUS_ERROR_INVALID_AGENT;
+            }
+            uint32_t dev_idx = agent.handle - 1;
+            const sim_device_t& dev = dev_list_[dev_idx];
+            bool is_gpu = (dev.type_ == HSA_DEVICE_TYPE_GPU);
+            switch ((uint32_t)attribute) {
+                case HSA_AGENT_INFO_NAME:
+                    snprintf((char*)value, 64, "%s", (is_gpu) ? "sim-gpu" : "sim-cpu");
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AGENT_INFO_DEVICE:
+                    *(hsa_device_type_t*)value = dev.type_;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AGENT_INFO_NODE:
+                    *(uint32_t*)value = dev_idx;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_AGENT_INFO_PRODUCT_NAME:
+                    snprintf((char*)value, 64, "%s", dev.name_.c_str());
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_AGENT_INFO_UUID:
+                    if (is_gpu) {
+                        snprintf((char*)value, 21, "GPU-%016x", dev_idx);
+                    } else {
+                        snprintf((char*)value, 21, "CPU-XX");
+                    }
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_AGENT_INFO_BDFID:
+                    *(uint32_t*)value = dev.bdf_id_;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_AGENT_INFO_DOMAIN:
+                    *(uint32_t*)value = 0;
+                    return HSA_STATUS_SUCCESS;
+                default:
+                    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+        }
+
+        hsa_status_t IteratePools(hsa_agent_t agent,
+                                  hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                           void* data),
+                                  void* data) {
+            if (ValidAgent(agent) == false) {
+                return HSA_STATUS_ERROR_INVALID_AGENT;
+            }
+            uint32_t first = (agent.handle - 1) * SIM_POOLS_PER_DEVICE;
+            for (uint32_t idx = first; idx < (first + SIM_POOLS_PER_DEVICE); idx++) {
+                hsa_amd_memory_pool_t pool = {idx + 1};
+                hsa_status_t status = callback(pool, data);
+                if (status != HSA_STATUS_SUCCESS) {
+                    return status;
+                }
+            }
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t GetPoolInfo(hsa_amd_memory_pool_t pool, hsa_amd_memory_pool_info_t attribute,
+                                 void* value) {
+            if (ValidPool(pool) == false) {
+                return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+            uint32_t pool_idx = pool.handle - 1;
+            const sim_device_t& dev = dev_list_[pool_idx / SIM_POOLS_PER_DEVICE];
+            switch (attribute) {
+                case HSA_AMD_MEMORY_POOL_INFO_SEGMENT:
+                    *(hsa_amd_segment_t*)value = HSA_AMD_SEGMENT_GLOBAL;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_MEMORY_POOL_INFO_GLOBAL_FLAGS:
+                    *(uint32_t*)value = GetPoolFlags(pool_idx);
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_MEMORY_POOL_INFO_SIZE:
+                    *(size_t*)value = dev.pool_size_;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALLOWED:
+                    *(bool*)value = true;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_MEMORY_POOL_INFO_ACCESSIBLE_BY_ALL:
+                    *(bool*)value = (dev.type_ == HSA_DEVICE_TYPE_CPU);
+                    return HSA_STATUS_SUCCESS;
+                default:
+                    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+        }
+
+        hsa_status_t GetAgentPoolInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                      hsa_amd_agent_memory_pool_info_t attribute, void* value) {
+            if ((ValidAgent(agent) == false) || (ValidPool(pool) == false)) {
+                return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+            uint32_t dev_idx = agent.handle - 1;
+            uint32_t owner_idx = (pool.handle - 1) / SIM_POOLS_PER_DEVICE;
+            const sim_link_t* link = FindLink(dev_idx, owner_idx);
+            switch (attribute) {
+                case HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS:
+                    *(hsa_amd_memory_pool_access_t*)value = GetAccess(dev_idx, owner_idx, link);
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS:
+                    *(uint32_t*)value = (link == NULL) ? 0 : link->hops_;
+                    return HSA_STATUS_SUCCESS;
+                case HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO:
+                    if (link == NULL) {
+                        return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+                    }
+                    GetLinkInfo(*link, (hsa_amd_memory_pool_link_info_t*)value);
+                    return HSA_STATUS_SUCCESS;
+                default:
+                    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+        }
+
+        hsa_status_t Allocate(hsa_amd_memory_pool_t pool, size_t size, void** ptr) {
+            if (ValidPool(pool) == false) {
+                return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+            }
+            uint32_t pool_idx = pool.handle - 1;
+            std::lock_guard<std::mutex> guard(lock_);
+            size_t pool_size = dev_list_[pool_idx / SIM_POOLS_PER_DEVICE].pool_size_;
+            if ((size + used_list_[pool_idx]) > pool_size) {
+                return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
+            }
+            *ptr = malloc((size == 0) ? 1 : size);
+            if (*ptr == NULL) {
+                return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
+            }
+            sim_alloc_t alloc;
+            alloc.size_ = size;
+            alloc.pool_ = pool_idx;
+            alloc_map_[(uintptr_t)*ptr] = alloc;
+            used_list_[pool_idx] += size;
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t Free(void* ptr) {
+            std::lock_guard<std::mutex> guard(lock_);
+            std::map<uintptr_t, sim_alloc_t>::iterator it = alloc_map_.find((uintptr_t)ptr);
+            if (it == alloc_map_.end()) {
+                return HSA_STATUS_ERROR_INVALID_ALLOCATION;
+            }
+            FlushMoves(NULL);
+            used_list_[it->second.pool_] -= it->second.size_;
+            alloc_map_.erase(it);
+            free(ptr);
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t AllowAccess(hsa_agent_t agent, const void* ptr) {
+            return (ValidAgent(agent)) ? HSA_STATUS_SUCCESS : HSA_STATUS_ERROR_INVALID_AGENT;
+        }
+
+        hsa_status_t CreateSignal(hsa_signal_value_t value, hsa_signal_t* signal) {
+            sim_signal_t* sim_signal = new sim_signal_t();
+            sim_signal->value_ = value;
+            sim_signal->start_ = sim_signal->end_ = 0;
+            signal->handle = (uint64_t)sim_signal;
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t DestroySignal(hsa_signal_t signal) {
+            std::lock_guard<std::mutex> guard(lock_);
+            FlushMoves((sim_signal_t*)signal.handle);
+            delete (sim_signal_t*)signal.handle;
+            return HSA_STATUS_SUCCESS;
+        }
+
+        void StoreSignal(hsa_signal_t signal, hsa_signal_value_t value) {
+            std::lock_guard<std::mutex> guard(lock_);
+            sim_signal_t* sim_signal = (sim_signal_t*)signal.handle;
+            sim_signal->value_ = value;
+            sim_signal->done_list_.clear();
+            if (value != 0) {
+                return;
+            }
+            uint64_t now = getSimTime();
+            for (uint32_t idx = 0; idx < sim_signal->gated_list_.size(); idx++) {
+                StartCopy(sim_signal->gated_list_[idx], now);
+            }
+            sim_signal->gated_list_.clear();
+        }
+
+        hsa_signal_value_t WaitSignal(hsa_signal_t signal, hsa_signal_condition_t condition,
+                                      hsa_signal_value_t value, hsa_wait_state_t policy) {
+            sim_signal_t* sim_signal = (sim_signal_t*)signal.handle;
+            while (true) {
+                hsa_signal_value_t curr;
+                {
+                    std::lock_guard<std::mutex> guard(lock_);
+                    SettleSignal(sim_signal, getSimTime());
+                    curr = sim_signal->value_;
+                }
+                if (SignalMeets(curr, condition, value)) {
+                    return curr;
+                }
+                if (policy == HSA_WAIT_STATE_BLOCKED) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(20));
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        hsa_status_t CopyAsync(void* dst, hsa_agent_t dst_agent, const void* src,
+                               hsa_agent_t src_agent, size_t size, uint32_t num_deps,
+                               const hsa_signal_t* deps, hsa_signal_t signal) {
+            std::lock_guard<std::mutex> guard(lock_);
+            int32_t src_dev_idx = FindDevice(src, size);
+            int32_t dst_dev_idx = FindDevice(dst, size);
+            if ((src_dev_idx < 0) || (dst_dev_idx < 0)) {
+                return HSA_STATUS_ERROR_INVALID_ALLOCATION;
+            }
+
+            // Copies within a device read and write its memory, which
+            // is reported as twice the data by the test
+            double bandwidth = dev_list_[src_dev_idx].bandwidth_;
+            double latency = dev_list_[src_dev_idx].latency_;
+            double bytes = (double)size * 2;
+            if (src_dev_idx != dst_dev_idx) {
+                const sim_link_t* link = FindLink(src_dev_idx, dst_dev_idx);
+                if (link == NULL) {
+                    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+                }
+                bandwidth = link->bandwidth_;
+                latency = link->latency_;
+                bytes = (double)size;
+            }
+
+            // Bandwidth in GB/s is bytes per nanosecond
+            sim_copy_t copy;
+            copy.channel_ = std::make_pair(src_dev_idx, dst_dev_idx);
+            copy.duration_ = (uint64_t)((latency * 1000) + (bytes / bandwidth));
+            copy.signal_ = (sim_signal_t*)signal.handle;
+
+            // Data is moved when signal is waited upon, so time host
+            // takes to move it does not hold back copies submitted next
+            sim_move_t move;
+            move.dst_ = dst;
+            move.src_ = src;
+            move.size_ = size;
+            move.signal_ = copy.signal_;
+            move_list_.push_back(move);
+
+            // Copy starts when submitted and signals it depends upon
+            // are zero. A signal reaches zero when its copies complete
+            // if all of them are submitted, else when it is set to zero
+            uint64_t now = getSimTime();
+            for (uint32_t idx = 0; idx < num_deps; idx++) {
+                sim_signal_t* dep = (sim_signal_t*)deps[idx].handle;
+                if (dep->value_ == 0) {
+                    continue;
+                }
+                vector<uint64_t>& done_list = dep->done_list_;
+                if (dep->value_ != (hsa_signal_value_t)done_list.size()) {
+                    dep->gated_list_.push_back(copy);
+                    return HSA_STATUS_SUCCESS;
+                }
+                now = std::max(now, *std::max_element(done_list.begin(), done_list.end()));
+            }
+            StartCopy(copy, now);
+            return HSA_STATUS_SUCCESS;
+        }
+
+        hsa_status_t EnableProfiling(bool enable) { return HSA_STATUS_SUCCESS; }
+
+        hsa_status_t GetCopyTime(hsa_signal_t signal, hsa_amd_profiling_async_copy_time_t* time) {
+            std::lock_guard<std::mutex> guard(lock_);
+            sim_signal_t* sim_signal = (sim_signal_t*)signal.handle;
+            time->start = sim_signal->start_;
+            time->end = sim_signal->end_;
+            return HSA_STATUS_SUCCESS;
+        }
+
+    private:
+        void LoadConfig();
+        bool AddDeviceKey(sim_device_t& dev, const std::string& key, const std::string& value);
+        bool AddLinkKey(sim_link_t& link, const std::string& key, const std::string& value);
+
+        bool ValidAgent(hsa_agent_t agent) const {
+            return ((agent.handle >= 1) && (agent.handle <= dev_list_.size()));
+        }
+
+        bool ValidPool(hsa_amd_memory_pool_t pool) const {
+            return ((pool.handle >= 1) && (pool.handle <= used_list_.size()));
+        }
+
+        uint32_t GetPoolFlags(uint32_t pool_idx) const {
+            const sim_device_t& dev = dev_list_[pool_idx / SIM_POOLS_PER_DEVICE];
+            const uint32_t* flags =
+                (dev.type_ == HSA_DEVICE_TYPE_CPU) ? SIM_CPU_POOL_FLAGS : SIM_GPU_POOL_FLAGS;
+            return flags[pool_idx % SIM_POOLS_PER_DEVICE];
+        }
+
+        const sim_link_t* FindLink(uint32_t dev1, uint32_t dev2) const {
+            for (uint32_t idx = 0; idx < link_list_.size(); idx++) {
+                const sim_link_t& link = link_list_[idx];
+                if (((link.dev1_ == dev1) && (link.dev2_ == dev2)) ||
+                    ((link.dev1_ == dev2) && (link.dev2_ == dev1))) {
+                    return &link;
+                }
+            }
+            return NULL;
+        }
+
+        // Access follows RocR: owner and every linked device may access
+        // system memory, Cpu may never access memory of a Gpu, and Gpus
+        // must be granted access to memory of a linked Gpu
+        hsa_amd_memory_pool_access_t GetAccess(uint32_t dev_idx, uint32_t owner_idx,
+                                               const sim_link_t* link) const {
+            if (dev_idx == owner_idx) {
+                return HSA_AMD_MEMORY_POOL_ACCESS_ALLOWED_BY_DEFAULT;
+            }
+            if ((link == NULL) || ((dev_list_[dev_idx].type_ == HSA_DEVICE_TYPE_CPU) &&
+                                   (dev_list_[owner_idx].type_ == HSA_DEVICE_TYPE_GPU))) {
+                return HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED;
+            }
+            if (dev_list_[owner_idx].type_ == HSA_DEVICE_TYPE_CPU) {
+                return HSA_AMD_MEMORY_POOL_ACCESS_ALLOWED_BY_DEFAULT;
+            }
+            return HSA_AMD_MEMORY_POOL_ACCESS_DISALLOWED_BY_DEFAULT;
+        }
+
+        // Weight of link is split among its hops as numa distance
+        void GetLinkInfo(const sim_link_t& link, hsa_amd_memory_pool_link_info_t* info) const {
+            for (uint32_t idx = 0; idx < link.hops_; idx++) {
+                std::memset(&info[idx], 0, sizeof(hsa_amd_memory_pool_link_info_t));
+                info[idx].link_type = link.type_;
+                info[idx].min_latency = (uint32_t)(link.latency_ * 1000);
+                info[idx].max_latency = (uint32_t)(link.latency_ * 1000);
+                info[idx].min_bandwidth = (uint32_t)(link.bandwidth_ * 1000);
+                info[idx].max_bandwidth = (uint32_t)(link.bandwidth_ * 1000);
+                info[idx].numa_distance = link.weight_ / link.hops_;
+            }
+            info[0].numa_distance += link.weight_ % link.hops_;
+        }
+
+        // Device owning buffer of size that begins at ptr, -1 if
+        // buffer is not within one allocation
+        int32_t FindDevice(const void* ptr, size_t size) const {
+            std::map<uintptr_t, sim_alloc_t>::const_iterator it =
+                alloc_map_.upper_bound((uintptr_t)ptr);
+            if (it == alloc_map_.begin()) {
+                return -1;
+            }
+            it--;
+            if (((uintptr_t)ptr + size) > (it->first + it->second.size_)) {
+                return -1;
+            }
+            return it->second.pool_ / SIM_POOLS_PER_DEVICE;
+        }
+
+        // Copies in the same direction between two devices run one
+        // after the other, others run alongside
+        void StartCopy(const sim_copy_t& copy, uint64_t now) {
+            uint64_t& busy = busy_map_[copy.channel_];
+            uint64_t start = (busy > now) ? busy : now;
+            busy = start + copy.duration_;
+            copy.signal_->start_ = start;
+            copy.signal_->end_ = busy;
+            copy.signal_->done_list_.push_back(busy);
+        }
+
+        void SettleSignal(sim_signal_t* sim_signal, uint64_t now) {
+            vector<uint64_t>& done_list = sim_signal->done_list_;
+            uint32_t idx = 0;
+            while (idx < done_list.size()) {
+                if (done_list[idx] > now) {
+                    idx++;
+                    continue;
+                }
+                FlushMoves(sim_signal);
+                sim_signal->value_--;
+                done_list.erase(done_list.begin() + idx);
+            }
+        }
+
+        // Moves data of copies in order of their submission, up to the
+        // last copy of signal, or of all copies if signal is NULL. As
+        // copies are submitted after those they depend upon, data each
+        // copy reads has been moved before it
+        void FlushMoves(const sim_signal_t* sim_signal) {
+            size_t cnt = move_list_.size();
+            if (sim_signal != NULL) {
+                while ((cnt > 0) && (move_list_[cnt - 1].signal_ != sim_signal)) {
+                    cnt--;
+                }
+            }
+            for (size_t idx = 0; idx < cnt; idx++) {
+                std::memmove(move_list_[idx].dst_, move_list_[idx].src_, move_list_[idx].size_);
+            }
+            move_list_.erase(move_list_.begin(), move_list_.begin() + cnt);
+        }
+
+        static bool SignalMeets(hsa_signal_value_t curr, hsa_signal_condition_t condition,
+                                hsa_signal_value_t value) {
+            switch (condition) {
+                case HSA_SIGNAL_CONDITION_EQ:
+                    return (curr == value);
+                case HSA_SIGNAL_CONDITION_NE:
+                    return (curr != value);
+                case HSA_SIGNAL_CONDITION_LT:
+                    return (curr < value);
+                default:
+                    return (curr >= value);
+            }
+        }
+
+        std::string config_path_;
+        uint32_t ref_cnt_;
+        vector<sim_device_t> dev_list_;
+        vector<sim_link_t> link_list_;
+
+        // Bytes in use of each pool and the buffers holding them
+        vector<size_t> used_list_;
+        std::map<uintptr_t, sim_alloc_t> alloc_map_;
+
+        // Time at which last copy in each direction between two
+        // devices completes
+        std::map<std::pair<int32_t, int32_t>, uint64_t> busy_map_;
+
+        // Data of copies yet to be moved, in order of submission
+        vector<sim_move_t> move_list_;
+        std::mutex lock_;
+};
+
+// Add key of a device, returns false if key is unknown or
+// its value is illegal
+bool SimTransport::AddDeviceKey(sim_device_t& dev, const std::string& key,
+                                const std::string& value) {
+    double num = 0;
+    if (key == "name") {
+        dev.name_ = value;
+        return true;
+    }
+    if (key == "memory") {
+        if (parseSimNumber(value, 1, 16777216, num) == false) {
+            return false;
+        }
+        dev.pool_size_ = (size_t)num * 1024 * 1024;
+        return true;
+    }
+    if (key == "bandwidth") {
+        if ((parseSimNumber(value, 0, 100000, num) == false) || (num == 0)) {
+            return false;
+        }
+        dev.bandwidth_ = num;
+        return true;
+    }
+    if (key == "latency") {
+        if (parseSimNumber(value, 0, 1000000, num) == false) {
+            return false;
+        }
+        dev.latency_ = num;
+        return true;
+    }
+    if (key == "bdf") {
+        uint32_t bus = 0;
+        uint32_t dev_id = 0;
+        uint32_t func = 0;
+        char extra = 0;
+        if ((sscanf(value.c_str(), "%x:%x.%x%c", &bus, &dev_id, &func, &extra) != 3) ||
+            (bus > 0xFF) || (dev_id > 0x1F) || (func > 0x7)) {
+            return false;
+        }
+        dev.bdf_id_ = (bus << 8) | (dev_id << 3) | func;
+        return true;
+    }
+    return false;
+}
+
+// Add key of a link, returns false if key is unknown or
+// its value is illegal
+bool SimTransport::AddLinkKey(sim_link_t& link, const std::string& key,
+                              const std::string& value) {
+    double num = 0;
+    if (key == "type") {
+        uint32_t count = sizeof(SIM_LINK_TYPES) / sizeof(SIM_LINK_TYPES[0]);
+        for (uint32_t idx = 0; idx < count; idx++) {
+            if (value == SIM_LINK_TYPES[idx].name_) {
+                link.type_ = SIM_LINK_TYPES[idx].type_;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (key == "bandwidth") {
+        if ((parseSimNumber(value, 0, 100000, num) == false) || (num == 0)) {
+            return false;
+        }
+        link.bandwidth_ = num;
+        return true;
+    }
+    if (key == "latency") {
+        if (parseSimNumber(value, 0, 1000000, num) == false) {
+            return false;
+        }
+        link.latency_ = num;
+        return true;
+    }
+    if (key == "hops") {
+        if (parseSimNumber(value, 1, 16, num) == false) {
+            return false;
+        }
+        link.hops_ = (uint32_t)num;
+        return true;
+    }
+    if (key == "weight") {
+        if (parseSimNumber(value, 1, 1000, num) == false) {
+            return false;
+        }
+        link.weight_ = (uint32_t)num;
+        return true;
+    }
+    return false;
+}
+
+void SimTransport::LoadConfig() {
+    std::ifstream in(config_path_.c_str());
+    if (in.is_open() == false) {
+        std::cout << "Unable to open simulation config: " << config_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Sections [cpu] and [gpu] add a device, numbered in order of
+    // appearance from 0. Section [link N M] binds devices N and M.
+    // Both are followed by lines of key = value. Lines starting
+    // with # or ; are comments
+    std::string line;
+    uint32_t line_num = 0;
+    vector<uint32_t> link_line_list;
+    bool in_link = false;
+    while (std::getline(in, line)) {
+        line_num++;
+        line = trimSimString(line);
+        if ((line.empty()) || (line[0] == '#') || (line[0] == ';')) {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            if (line[line.size() - 1] != ']') {
+                exitSimError(config_path_, line_num, "Illegal name of section");
+            }
+            std::string name = trimSimString(line.substr(1, line.size() - 2));
+            if ((name == "cpu") || (name == "gpu")) {
+                // Models of devices default to those of a typical
+                // host and discrete Gpu
+                sim_device_t dev;
+                bool is_gpu = (name == "gpu");
+                dev.type_ = (is_gpu) ? HSA_DEVICE_TYPE_GPU : HSA_DEVICE_TYPE_CPU;
+                dev.name_ = (is_gpu) ? "Simulated GPU" : "Simulated CPU";
+                dev.pool_size_ = (size_t)((is_gpu) ? 16384 : 65536) * 1024 * 1024;
+                dev.bdf_id_ = (is_gpu) ? ((uint32_t)dev_list_.size() << 8) : 0;
+                dev.bandwidth_ = (is_gpu) ? 1000 : 40;
+                dev.latency_ = 2;
+                dev_list_.push_back(dev);
+                in_link = false;
+                continue;
+            }
+
+            std::istringstream stream(name);
+            std::string word;
+            int64_t dev1 = -1;
+            int64_t dev2 = -1;
+            stream >> word >> dev1 >> dev2;
+            if ((word != "link") || (stream.fail()) || ((stream >> word).eof() == false)) {
+                exitSimError(config_path_, line_num, "Expected [cpu], [gpu] or [link N M]");
+            }
+
+            // Links default to a PCIe link of one hop
+            sim_link_t link;
+            link.dev1_ = (uint32_t)dev1;
+            link.dev2_ = (uint32_t)dev2;
+            link.type_ = HSA_AMD_LINK_INFO_TYPE_PCIE;
+            link.hops_ = 1;
+            link.weight_ = 20;
+            link.bandwidth_ = 25;
+            link.latency_ = 10;
+            if ((dev1 < 0) || (dev2 < 0) || (dev1 == dev2)) {
+                exitSimError(config_path_, line_num, "Link must bind two different devices");
+            }
+            link_list_.push_back(link);
+            link_line_list.push_back(line_num);
+            in_link = true;
+            continue;
+        }
+
+        size_t pos = line.find('=');
+        if ((pos == std::string::npos) || (dev_list_.empty())) {
+            exitSimError(config_path_, line_num, "Expected [section] or key = value");
+        }
+        std::string key = trimSimString(line.substr(0, pos));
+        std::string value = trimSimString(line.substr(pos + 1));
+        bool valid = (in_link) ? AddLinkKey(link_list_.back(), key, value)
+                               : AddDeviceKey(dev_list_.back(), key, value);
+        if ((value.empty()) || (valid == false)) {
+            exitSimError(config_path_, line_num, "Unknown key or illegal value: " + line);
+        }
+    }
+
+    bool has_cpu = false;
+    for (uint32_t idx = 0; idx < dev_list_.size(); idx++) {
+        has_cpu |= (dev_list_[idx].type_ == HSA_DEVICE_TYPE_CPU);
+    }
+    if (has_cpu == false) {
+        std::cout << "Simulation config has no cpu device: " << config_path_ << std::endl;
+        exit_test(1);
+    }
+
+    // Links must bind devices that exist, at most once
+    for (uint32_t idx = 0; idx < link_list_.size(); idx++) {
+        const sim_link_t& link = link_list_[idx];
+        if ((link.dev1_ >= dev_list_.size()) || (link.dev2_ >= dev_list_.size())) {
+            exitSimError(config_path_, link_line_list[idx], "Link binds an unknown device");
+        }
+        if (FindLink(link.dev1_, link.dev2_) != &link) {
+            exitSimError(config_path_, link_line_list[idx], "Devices are already linked");
+        }
+    }
+
+    // Buffers of a Gpu are initialized and validated from memory
+    // of a Cpu, so each must be linked to one
+    for (uint32_t idx = 0; idx < dev_list_.size(); idx++) {
+        bool has_cpu_link = (dev_list_[idx].type_ == HSA_DEVICE_TYPE_CPU);
+        for (uint32_t jdx = 0; jdx < dev_list_.size(); jdx++) {
+            has_cpu_link |= ((dev_list_[jdx].type_ == HSA_DEVICE_TYPE_CPU) &&
+                             (FindLink(idx, jdx) != NULL));
+        }
+        if (has_cpu_link == false) {
+            std::cout << "Simulation config has gpu " << idx << " with no link to a cpu: "
+                      << config_path_ << std::endl;
+            exit_test(1);
+        }
+    }
+
+    used_list_.resize(dev_list_.size() * SIM_POOLS_PER_DEVICE, 0);
+}
+
+Transport* CreateSimTransport(const std::string& config_path) {
+    return new SimTransport(config_path);
+}